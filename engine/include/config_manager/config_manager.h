@@ -37,7 +37,7 @@ public:
         auto it = m_config_values.find(key);
         if (it != m_config_values.end()) {
             try {
-                std::cout << "[---------------] Config: " << key << " is found: " << std::get<int>(it->second) << std::endl;;
+                std::cout << "[---------------] Config: " << key << " is found" << std::endl;
                 return std::get<T>(it->second);
             } catch (const std::bad_variant_access&) {
                 return default_value;
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/macros.h"
+
+// Tracks a batch of jobs. JobSystem::wait(group) returns once every job
+// submitted with it has finished, and rethrows the first exception any of them threw.
+class JobGroup {
+public:
+    inline bool is_done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<size_t> m_pending{0};
+    std::mutex m_exception_mutex;
+    std::exception_ptr m_exception;
+};
+
+// Engine-owned work-stealing thread pool. Every thread, the main thread
+// included, owns a queue: jobs are pushed to and popped from the back of the
+// submitting thread's queue, and idle threads steal from the front of the others.
+class JobSystem {
+    MAKE_SINGLETON(JobSystem);
+
+public:
+    void submit(JobGroup& group, std::function<void()> task);
+
+    // Blocks until the group is done. The calling thread runs queued jobs while it waits.
+    void wait(JobGroup& group);
+
+    // Splits [0, count) into chunks of at least min_chunk elements and calls
+    // fn(begin, end) for each of them across the pool. Returns once all chunks ran.
+    template<typename F>
+    void parallel_for(size_t count, size_t min_chunk, F&& fn) {
+        if (count == 0) {
+            return;
+        }
+
+        const size_t chunk_count = get_chunk_count(count, min_chunk);
+        if (chunk_count <= 1) {
+            fn(size_t(0), count);
+            return;
+        }
+
+        const size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+
+        JobGroup group;
+        for (size_t begin = chunk_size; begin < count; begin += chunk_size) {
+            const size_t end = std::min(begin + chunk_size, count);
+            submit(group, [&fn, begin, end]() { fn(begin, end); });
+        }
+
+        // first chunk runs on the calling thread while the others are stolen
+        try {
+            fn(size_t(0), std::min(chunk_size, count));
+        } catch (...) {
+            wait(group);
+            throw;
+        }
+
+        wait(group);
+    }
+
+    inline size_t get_thread_count() const { return m_queues.size(); }
+    inline size_t get_worker_count() const { return m_workers.size(); }
+
+private:
+    JobSystem();
+    ~JobSystem();
+
+    struct Job {
+        std::function<void()> task;
+        JobGroup* group = nullptr;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    size_t get_chunk_count(size_t count, size_t min_chunk) const;
+
+    bool pop(size_t queue_index, Job& job);
+    bool steal(size_t thief_index, Job& job);
+    bool try_run_one(size_t queue_index);
+    void execute(Job& job);
+    void worker_loop(size_t queue_index);
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::atomic<bool> m_running{true};
+    std::atomic<size_t> m_queued{0};
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+};
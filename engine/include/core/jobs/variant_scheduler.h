@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "core/jobs/job_system.h"
+#include "variant/variant_access.h"
+
+// Splits the variant types into batches whose on_play_update can run at the
+// same time. Batches keep the dispatch order, so any two conflicting types still
+// run in the order the sequential loop would run them.
+class VariantScheduler {
+public:
+    // Rebuild after changing the dispatch order.
+    void build();
+
+    // fn(variant_type_index) is called once per type. Types of a batch run
+    // across the job system, batches run one after another.
+    template<typename F>
+    void run(F&& fn) {
+        JobSystem& jobs = JobSystem::get();
+
+        for (const auto& batch : m_batches) {
+            if (batch.size() == 1) {
+                fn(batch[0]);
+                continue;
+            }
+
+            JobGroup group;
+            for (size_t i = 1; i < batch.size(); i++) {
+                const variant_type_index index = batch[i];
+                jobs.submit(group, [&fn, index]() { fn(index); });
+            }
+
+            try {
+                fn(batch[0]);
+            } catch (...) {
+                jobs.wait(group);
+                throw;
+            }
+
+            jobs.wait(group);
+        }
+    }
+
+    inline const std::vector<std::vector<variant_type_index>>& get_batches() const { return m_batches; }
+
+private:
+    std::vector<std::vector<variant_type_index>> m_batches;
+};
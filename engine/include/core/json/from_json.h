@@ -5,5 +5,5 @@
 #include "rttr/variant.h"
 
 namespace rttr_json {
-    entity_id deserialize_entity(const std::string& entity_json, entity_id& entity, std::vector<rttr::variant>& variants);
+    entity_guid deserialize_entity(const std::string& entity_json, entity_guid& entity, std::vector<rttr::variant>& variants);
 }
@@ -6,8 +6,10 @@
 #include <rttr/variant.h>
 #include <filesystem>
 
+struct VariantBase;
+
 namespace rttr_json {
-    std::string serialize_entity(const entity_id entity_id, const std::vector<rttr::variant>& variants);
-    std::string serialize_entity(const entity_id entity_id, const std::vector<rttr::variant>& variants, const std::filesystem::path& path);
+    std::string serialize_entity(const entity_guid guid, const std::vector<VariantBase*>& variants);
+    std::string serialize_entity(const entity_guid guid, const std::vector<VariantBase*>& variants, const std::filesystem::path& path);
     void create_dummy(const rttr::type& type);
 }
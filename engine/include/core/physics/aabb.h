@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+#include "raylib.h"
+
+// Axis-aligned box in world space, what the broadphases sort and compare.
+struct Aabb {
+    Vector2 min;
+    Vector2 max;
+};
+
+inline bool overlaps(const Aabb& a, const Aabb& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+inline bool contains(const Aabb& outer, const Aabb& inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y;
+}
+
+inline Aabb combine(const Aabb& a, const Aabb& b) {
+    return Aabb{
+        { a.min.x < b.min.x ? a.min.x : b.min.x, a.min.y < b.min.y ? a.min.y : b.min.y },
+        { a.max.x > b.max.x ? a.max.x : b.max.x, a.max.y > b.max.y ? a.max.y : b.max.y }
+    };
+}
+
+inline Aabb expand(const Aabb& bounds, float margin) {
+    return Aabb{
+        { bounds.min.x - margin, bounds.min.y - margin },
+        { bounds.max.x + margin, bounds.max.y + margin }
+    };
+}
+
+// Cost measure of the tree broadphase; perimeter rather than area, so thin boxes still count.
+inline float perimeter(const Aabb& bounds) {
+    return 2.0f * ((bounds.max.x - bounds.min.x) + (bounds.max.y - bounds.min.y));
+}
+
+// Candidate pair found by a broadphase, by the callers' proxy ids, lower id first.
+struct ProxyPair {
+    uint32_t a;
+    uint32_t b;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/physics/aabb.h"
+
+// Dynamic bounding volume hierarchy. Every proxy is a leaf holding its bounds
+// grown by a margin, so a box that moves a little stays inside its leaf and costs
+// nothing; only boxes leaving their fat bounds are taken out and re-inserted.
+// Inserts pick the sibling that grows the tree's total perimeter least and the
+// path back to the root is rebalanced with rotations, which keeps the tree
+// shallow whatever mix of box sizes it holds.
+// Nodes live in one array and are addressed by index; proxy ids are leaf indices.
+class AabbTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+
+    explicit AabbTree(float margin = 8.0f) : m_margin(margin) {}
+
+    // Applies to bounds set from now on.
+    inline void set_margin(float margin) { m_margin = margin; }
+
+    int32_t create_proxy(const Aabb& bounds, uint64_t user_data);
+    void destroy_proxy(int32_t proxy);
+    // Returns true when bounds left the proxy's fat bounds and the leaf was re-inserted.
+    bool move_proxy(int32_t proxy, const Aabb& bounds);
+    void clear();
+
+    inline const Aabb& get_fat_bounds(int32_t proxy) const { return m_nodes[proxy].bounds; }
+    inline uint64_t get_user_data(int32_t proxy) const { return m_nodes[proxy].user_data; }
+    inline size_t get_proxy_count() const { return m_proxy_count; }
+    // Upper bound of the proxy ids handed out so far, for arrays indexed by proxy.
+    inline size_t get_node_capacity() const { return m_nodes.size(); }
+    inline int32_t get_height() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+
+    // fn(proxy) for every proxy whose fat bounds overlap bounds. Uses a stack
+    // owned by the tree, so queries on one tree must not run concurrently.
+    template<typename F>
+    void query(const Aabb& bounds, F&& fn) const {
+        if (m_root == NULL_NODE) {
+            return;
+        }
+
+        m_stack.clear();
+        m_stack.push_back(m_root);
+
+        while (!m_stack.empty()) {
+            const int32_t index = m_stack.back();
+            m_stack.pop_back();
+
+            const Node& node = m_nodes[index];
+            if (!overlaps(node.bounds, bounds)) {
+                continue;
+            }
+
+            if (node.is_leaf()) {
+                fn(index);
+            } else {
+                m_stack.push_back(node.child1);
+                m_stack.push_back(node.child2);
+            }
+        }
+    }
+
+private:
+    struct Node {
+        Aabb bounds;
+        uint64_t user_data = 0;
+        // next free node while the node is on the free list
+        int32_t parent = NULL_NODE;
+        int32_t child1 = NULL_NODE;
+        int32_t child2 = NULL_NODE;
+        // 0 for leaves, -1 for free nodes
+        int32_t height = -1;
+
+        inline bool is_leaf() const { return child1 == NULL_NODE; }
+    };
+
+    int32_t allocate_node();
+    void free_node(int32_t index);
+
+    void insert_leaf(int32_t leaf);
+    void remove_leaf(int32_t leaf);
+    // Refits and rebalances every node from index up to the root.
+    void fix_upwards(int32_t index);
+    // Rotates the taller grandchild up when the subtree at index leans by more than one level.
+    int32_t balance(int32_t index);
+
+    float m_margin;
+
+    std::vector<Node> m_nodes;
+    int32_t m_root = NULL_NODE;
+    int32_t m_free = NULL_NODE;
+    size_t m_proxy_count = 0;
+
+    mutable std::vector<int32_t> m_stack;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "entity/entity.h"
+#include "core/physics/aabb.h"
+#include "core/physics/aabb_tree.h"
+#include "core/physics/spatial_hash_grid.h"
+
+enum class BroadPhaseType : int {
+    AabbTree = 0,
+    Grid = 1,
+};
+
+// Candidate pairs for CollisionSystem. Every step the caller reports each body
+// once, numbered densely from 0, and find_pairs returns the pairs of bodies whose
+// bounds overlap, by those numbers.
+// Dynamic bodies go into the tree, where a body keeps its proxy across steps,
+// keyed by its entity, so one that barely moved costs a containment test, or into
+// the grid, which is refilled every step and only pays off for crowds of similar
+// sized bodies. Static bodies get a tree of their own without margins that is
+// only touched when one of them is added, removed, moved or resized; dynamic
+// bodies are tested against it in a separate pass and statics never against
+// each other. Proxies of entities not reported in a step are dropped.
+class BroadPhase {
+public:
+    void set_type(BroadPhaseType type);
+    inline BroadPhaseType get_type() const { return m_type; }
+    inline void set_cell_size(float cell_size) { m_grid.set_cell_size(cell_size); }
+    inline void set_margin(float margin) { m_tree.set_margin(margin); }
+
+    void begin_step();
+    void update(uint32_t body, entity_id owner, const Aabb& bounds, bool is_static);
+    void find_pairs(std::vector<ProxyPair>& pairs);
+    // Bodies whose bounds overlap bounds, by body number. Only valid after find_pairs.
+    void query(const Aabb& bounds, std::vector<uint32_t>& bodies) const;
+
+    inline const AabbTree& get_tree() const { return m_tree; }
+    inline const AabbTree& get_static_tree() const { return m_static_tree; }
+
+private:
+    struct TrackedProxy {
+        int32_t proxy = AabbTree::NULL_NODE;
+        entity_id owner = INVALID_ENTITY;
+        uint32_t step = 0;
+        bool is_static = false;
+        // statics only, to tell when they moved or were resized
+        Aabb bounds;
+    };
+
+    void update_dynamic(uint32_t body, TrackedProxy& tracked, const Aabb& bounds);
+    void update_static(uint32_t body, TrackedProxy& tracked, const Aabb& bounds);
+    void find_dynamic_pairs(std::vector<ProxyPair>& pairs);
+    void find_static_pairs(std::vector<ProxyPair>& pairs);
+
+    void destroy_proxy(TrackedProxy& tracked);
+    void drop_unreported();
+    void reset();
+
+    BroadPhaseType m_type = BroadPhaseType::AabbTree;
+    SpatialHashGrid m_grid;
+    AabbTree m_tree;
+    AabbTree m_static_tree{0.0f};
+    uint32_t m_step = 0;
+
+    // by entity index
+    std::vector<TrackedProxy> m_tracked;
+    // entity indices that hold a proxy in either tree
+    std::vector<uint32_t> m_tracked_indices;
+
+    // this step's bodies, by body number
+    std::vector<Aabb> m_body_bounds;
+    std::vector<uint32_t> m_dynamic_bodies;
+    // body number of each reported proxy, by tree node
+    std::vector<uint32_t> m_proxy_bodies;
+    std::vector<uint32_t> m_static_proxy_bodies;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "entity/entity.h"
+
+// Two bodies touching, by entity with the lower entity first, plus their body
+// numbers in the step that reported them.
+struct Contact {
+    entity_id a;
+    entity_id b;
+    uint32_t body_a;
+    uint32_t body_b;
+};
+
+// Remembers which pairs touched in the previous step. Each step the caller adds
+// the pairs touching now and update sorts them and diffs them against the
+// previous step's in one merge pass: pairs new this step are entered, pairs
+// seen in both steps stayed, and pairs only in the previous step exited. Exited
+// contacts carry the previous step's body numbers, so resolve them by entity.
+class ContactCache {
+public:
+    void begin_step();
+    void add(entity_id a, entity_id b, uint32_t body_a, uint32_t body_b);
+    void update();
+    // A contact that begins after update, e.g. a swept body's later impact in the
+    // same step. Returns false when the pair already touches this step.
+    bool add_entered(entity_id a, entity_id b, uint32_t body_a, uint32_t body_b);
+    void clear();
+
+    inline const std::vector<Contact>& get_entered() const { return m_entered; }
+    inline const std::vector<Contact>& get_stayed() const { return m_stayed; }
+    inline const std::vector<Contact>& get_exited() const { return m_exited; }
+    inline size_t size() const { return m_previous.size(); }
+
+private:
+    // sorted, after update
+    std::vector<Contact> m_previous;
+    std::vector<Contact> m_current;
+
+    std::vector<Contact> m_entered;
+    std::vector<Contact> m_stayed;
+    std::vector<Contact> m_exited;
+};
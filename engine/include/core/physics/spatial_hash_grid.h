@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/physics/aabb.h"
+
+// Uniform grid broadphase. Every box is filed under each cell it touches and only
+// boxes sharing a cell are compared, so the cost follows the number of neighbours
+// instead of the square of the box count. Meant to be refilled every step:
+// clear, insert every box, build, then ask for pairs or run queries.
+// Proxy ids are the caller's, ideally dense indices into its own arrays.
+class SpatialHashGrid {
+public:
+    explicit SpatialHashGrid(float cell_size = 128.0f) : m_cell_size(cell_size) {}
+
+    // Takes effect from the next clear.
+    inline void set_cell_size(float cell_size) { m_next_cell_size = cell_size; }
+    inline float get_cell_size() const { return m_cell_size; }
+
+    void clear();
+    void insert(uint32_t proxy, const Aabb& bounds);
+    // Sorts the cells; pairs and queries are only valid after it.
+    void build();
+
+    // Every pair of overlapping boxes, once each.
+    void find_pairs(std::vector<ProxyPair>& pairs) const;
+    // Every box overlapping bounds, once each.
+    void query(const Aabb& bounds, std::vector<uint32_t>& results) const;
+
+    inline size_t get_proxy_count() const { return m_proxies; }
+    inline size_t get_cell_entry_count() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        uint64_t cell;
+        uint32_t proxy;
+    };
+
+    struct CellRange {
+        int32_t min_x, min_y, max_x, max_y;
+    };
+
+    CellRange get_cells(const Aabb& bounds) const;
+    // Two boxes sharing several cells are only reported from the cell holding the
+    // min corner of their overlap.
+    bool owns_overlap(uint64_t cell, const Aabb& a, const Aabb& b) const;
+
+    float m_cell_size;
+    float m_next_cell_size = 0.0f;
+    size_t m_proxies = 0;
+
+    std::vector<Entry> m_entries;
+    // indexed by proxy id
+    std::vector<Aabb> m_bounds;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+#include "raylib.h"
+
+#include "entity/entity.h"
+#include "core/physics/aabb.h"
+
+// A swept body that hit something during the step: its body number and the
+// fraction of the step it has used up so far.
+struct Impact {
+    entity_id id;
+    uint32_t body;
+    float time;
+};
+
+// Time of impact queries for a circle moving along motion during one step, the
+// target holding still. Both return the fraction of motion, in [0, 1], at which
+// the shapes first touch, or a negative value when they do not touch during the
+// motion or already overlap at its start, which the discrete test covers.
+
+// The circle against a box, done as a ray against the box grown by radius with
+// rounded corners.
+float sweep_circle_aabb(Vector2 center, float radius, Vector2 motion, const Aabb& box);
+float sweep_circle_circle(Vector2 center, float radius, Vector2 motion, Vector2 other_center, float other_radius);
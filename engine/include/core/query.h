@@ -4,11 +4,18 @@
 #include <functional>
 #include <type_traits>
 #include <optional>
+#include <tuple>
 
 #include "core/zeytin.h"
+#include "core/variant_handle.h"
+#include "core/jobs/job_system.h"
 #include "rttr/variant.h"
 #include "entity/entity.h"
 #include "variant/variant_base.h"
+#include "core/storage/variant_pool.h"
+#include "core/storage/variant_view.h"
+#include "core/storage/variant_range.h"
+#include "variant/variant_type.h"
 
 namespace Query {
 
@@ -16,18 +23,22 @@ inline entity_id create_entity() {
     return Zeytin::get().new_entity_id();
 }
 
+// Deferred structural changes. Safe to record while iterating or from jobs;
+// they are applied at the next sync point of the frame.
+inline CommandBuffer& commands() {
+    return Zeytin::get().get_commands();
+}
+
+template<typename... Ts>
+bool has_types(entity_id id) {
+    static_assert((std::is_base_of<VariantBase, Ts>::value && ...), "Ts must derive from VariantBase");
+    return Zeytin::get().get_storage().has_variants(id, variant_mask_of<Ts...>);
+}
+
 template<typename T>
 bool has(entity_id id) {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
-    auto& variants = Zeytin::get().get_variants(id);
-    
-    for (const auto& variant : variants) {
-        if (variant.get_type() == rttr::type::get<T>()) {
-            return true;
-        }
-    }
-    
-    return false;
+    return Zeytin::get().get_storage().has_variant(id, VariantTypeIndex<T>::value);
 }
 
 template<typename T>
@@ -42,7 +53,7 @@ bool has(VariantBase* base) {
 
 template<typename T1, typename T2, typename... Rest>
 bool has(entity_id id) {
-    return has<T1>(id) && has<T2, Rest...>(id);
+    return has_types<T1, T2, Rest...>(id);
 }
 
 template<typename T1, typename T2, typename... Rest>
@@ -51,18 +62,41 @@ bool has(const VariantBase* base) {
 }
 
 
+// Lookups against an already resolved storage, so the variadic forms fetch the
+// world once and then do one indexed pool lookup per type.
+namespace detail {
+
 template<typename T>
-T& get(entity_id id) {
+T& get_from(VariantStorage& storage, entity_id id) {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
-    auto& variants = Zeytin::get().get_variants(id);
+    VariantBase* variant = storage.find_variant_for_write(id, VariantTypeIndex<T>::value);
 
-    for (auto& variant : variants) {
-        if (variant.get_type() == rttr::type::get<T>()) {
-            return variant.get_value<T&>();
-        }
+    if (variant) {
+        return *static_cast<T*>(variant);
     }
 
-    throw std::runtime_error("Component not found despite has() check");
+    throw std::runtime_error(std::string("Component not found despite has() check: ") + VARIANT_TYPE_NAMES[VariantTypeIndex<T>::value]);
+}
+
+template<typename T>
+const T& read_from(const VariantStorage& storage, entity_id id) {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    const VariantBase* variant = storage.find_variant(id, VariantTypeIndex<T>::value);
+
+    if (variant) {
+        return *static_cast<const T*>(variant);
+    }
+
+    throw std::runtime_error(std::string("Component not found despite has() check: ") + VARIANT_TYPE_NAMES[VariantTypeIndex<T>::value]);
+}
+
+}
+
+// get and try_get hand out mutable access and mark the variant as changed
+// (see changed<T>); use read for read-only access.
+template<typename T>
+T& get(entity_id id) {
+    return detail::get_from<T>(Zeytin::get().get_storage(), id);
 }
 
 template<typename T>
@@ -72,7 +106,8 @@ T& get(const VariantBase* base) {
 
 template<typename T1, typename T2, typename... Rest>
 std::tuple<T1&, T2&, Rest&...> get(entity_id id) {
-    return std::tie(get<T1>(id), get<T2>(id), get<Rest>(id)...);
+    VariantStorage& storage = Zeytin::get().get_storage();
+    return std::tie(detail::get_from<T1>(storage, id), detail::get_from<T2>(storage, id), detail::get_from<Rest>(storage, id)...);
 }
 
 template<typename T1, typename T2, typename... Rest>
@@ -82,8 +117,11 @@ std::tuple<T1&, T2&, Rest&...> get(const VariantBase* base) {
 
 template<typename T>
 std::optional<std::reference_wrapper<T>> try_get(entity_id id) {
-    if (has<T>(id)) {
-        return std::optional<std::reference_wrapper<T>>(std::ref(get<T>(id)));
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    VariantBase* variant = Zeytin::get().get_storage().find_variant_for_write(id, VariantTypeIndex<T>::value);
+
+    if (variant) {
+        return std::optional<std::reference_wrapper<T>>(std::ref(*static_cast<T*>(variant)));
     }
     return std::nullopt;
 }
@@ -95,8 +133,7 @@ std::optional<std::reference_wrapper<T>> try_get(const VariantBase* base) {
 
 template<typename T>
 const T& read(entity_id id) {
-    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
-    return get<T>(id);
+    return detail::read_from<T>(Zeytin::get().get_storage(), id);
 }
 
 template<typename T>
@@ -106,7 +143,8 @@ const T& read(const VariantBase* base) {
 
 template<typename T1, typename T2, typename... Rest>
 std::tuple<const T1&, const T2&, const Rest&...> read(entity_id id) {
-    return std::tie(read<T1>(id), read<T2>(id), read<Rest>(id)...);
+    const VariantStorage& storage = Zeytin::get().get_storage();
+    return std::tie(detail::read_from<T1>(storage, id), detail::read_from<T2>(storage, id), detail::read_from<Rest>(storage, id)...);
 }
 
 template<typename T1, typename T2, typename... Rest>
@@ -114,84 +152,160 @@ std::tuple<const T1&, const T2&, const Rest&...> read(const VariantBase* base) {
     return read<T1, T2, Rest...>(base->entity_id);
 }
 
+// See VariantHandle; for callbacks that may run after variant is gone.
+template<typename T>
+VariantHandle<T> handle(const T& variant) {
+    return VariantHandle<T>(variant);
+}
+
 template<typename T>
 std::optional<std::reference_wrapper<T>> try_find_first() {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
-    const rttr::type& type = rttr::type::get<T>();
-    
-    for (auto& [entity_id, variants] : Zeytin::get().get_storage()) {
-        for (auto& variant : variants) {
-            if (variant.get_type() == type) {
-                return std::ref(variant.get_value<T&>());
-            }
+    if constexpr (is_singleton_variant_v<T>) {
+        if (VariantBase* singleton = Zeytin::get().get_storage().find_singleton(VariantTypeIndex<T>::value)) {
+            return std::ref(*static_cast<T*>(singleton));
+        }
+
+        return std::nullopt;
+    } else {
+        VariantPool* pool = Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value);
+
+        if (pool && !pool->empty()) {
+            return std::ref(*static_cast<T*>(pool->get_variants().front()));
         }
+
+        return std::nullopt;
     }
-    
-    return std::nullopt;
 }
 
 template<typename T>
 T& find_first() {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
-    const rttr::type& type = rttr::type::get<T>();
-    
-    for (auto& [entity_id, variants] : Zeytin::get().get_storage()) {
-        for (auto& variant : variants) {
-            if (variant.get_type() == type) {
-                return variant.get_value<T&>();
-            }
-        }
+    if (auto result = try_find_first<T>()) {
+        return result->get();
     }
     
-    throw std::runtime_error("Not able to find_first: " + type.get_name().to_string()); 
+    throw std::runtime_error(std::string("Not able to find_first: ") + VARIANT_TYPE_NAMES[VariantTypeIndex<T>::value]); 
 }
 
 template<typename T>
 std::vector<std::reference_wrapper<T>> find_all() {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
     std::vector<std::reference_wrapper<T>> results;
-    const rttr::type& type = rttr::type::get<T>();
+    VariantPool* pool = Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value);
+
+    if (!pool) {
+        return results;
+    }
     
-    for (auto& [entity_id, variants] : Zeytin::get().get_storage()) {
-        for (auto& variant : variants) {
-            if (variant.get_type() == type) {
-                T& component = variant.get_value<T&>();
-                results.push_back(std::ref(component));
-            }
-        }
+    results.reserve(pool->size());
+    for (VariantBase* variant : pool->get_variants()) {
+        results.push_back(std::ref(*static_cast<T*>(variant)));
     }
     
     return results;
 }
 
+template<typename T>
+VariantRange<T> all() {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    return VariantRange<T>(Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value));
+}
+
+template<typename T, typename Predicate>
+FilteredVariantRange<T, std::decay_t<Predicate>> where(Predicate&& predicate) {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    return FilteredVariantRange<T, std::decay_t<Predicate>>(
+        Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value),
+        std::forward<Predicate>(predicate)
+    );
+}
+
+inline uint32_t current_tick() {
+    return Zeytin::get().get_storage().get_tick();
+}
+
+// Seconds covered by one on_play_update; play updates run at the fixed tick_rate.
+inline float delta_time() {
+    return Zeytin::get().get_fixed_delta();
+}
+
+// A copy of id's T for drawing, its SOA() fields blended between the last two
+// fixed steps so motion stays smooth when frames and steps do not line up.
+template<typename T>
+T interpolated(entity_id id) {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    const VariantStorage& storage = Zeytin::get().get_storage();
+
+    T result = detail::read_from<T>(storage, id);
+    storage.find_pool(VariantTypeIndex<T>::value)->interpolate(id, Zeytin::get().get_interpolation_alpha(), result);
+    return result;
+}
+
+template<typename T>
+T interpolated(const VariantBase* base) {
+    return interpolated<T>(base->entity_id);
+}
+
+// Variants of T added at or after tick since. Without since: added this frame or the previous one.
+template<typename T>
+TickFilteredVariantRange<T> added(uint32_t since) {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    VariantPool* pool = Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value);
+    return TickFilteredVariantRange<T>(pool, pool ? &pool->get_added_ticks() : nullptr, since);
+}
+
+template<typename T>
+TickFilteredVariantRange<T> added() {
+    return added<T>(current_tick() - 1);
+}
+
+// Variants of T added or written through get/try_get/mark_changed at or after tick since.
+// Without since: this frame or the previous one. Iterating (for_each, all, view) is not a write.
+template<typename T>
+TickFilteredVariantRange<T> changed(uint32_t since) {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    VariantPool* pool = Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value);
+    return TickFilteredVariantRange<T>(pool, pool ? &pool->get_changed_ticks() : nullptr, since);
+}
+
+template<typename T>
+TickFilteredVariantRange<T> changed() {
+    return changed<T>(current_tick() - 1);
+}
+
+template<typename T>
+void mark_changed(entity_id id) {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    Zeytin::get().get_storage().find_variant_for_write(id, VariantTypeIndex<T>::value);
+}
+
+template<typename T, typename... Rest>
+VariantView<T, Rest...>& view() {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    return Zeytin::get().get_storage().get_view<VariantView<T, Rest...>>();
+}
+
 template<typename T, typename... Rest>
 std::vector<entity_id> find_all_with() {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
-    std::vector<entity_id> results;
-    
-    for (auto& [entity_id, variants] : Zeytin::get().get_storage()) {
-        if (has<T, Rest...>(entity_id)) {
-            results.push_back(entity_id);
-        }
-    }
-    
-    return results;
+    return view<T, Rest...>().get_entities();
 }
 
-template<typename T>
-std::vector<std::reference_wrapper<T>> find_where(std::function<bool(T&)> predicate) {
+template<typename T, typename Predicate>
+std::vector<std::reference_wrapper<T>> find_where(Predicate&& predicate) {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
     std::vector<std::reference_wrapper<T>> results;
-    const rttr::type& type = rttr::type::get<T>();
+    VariantPool* pool = Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value);
+
+    if (!pool) {
+        return results;
+    }
     
-    for (auto& [entity_id, variants] : Zeytin::get().get_storage()) {
-        for (auto& variant : variants) {
-            if (variant.get_type() == type) {
-                T& component = variant.get_value<T&>();
-                if (predicate(component)) {
-                    results.push_back(std::ref(component));
-                }
-            }
+    for (VariantBase* variant : pool->get_variants()) {
+        T& component = *static_cast<T*>(variant);
+        if (predicate(component)) {
+            results.push_back(std::ref(component));
         }
     }
     
@@ -199,69 +313,113 @@ std::vector<std::reference_wrapper<T>> find_where(std::function<bool(T&)> predic
 }
 
 
-template<typename T, typename... Rest>
-bool has_types(const std::vector<rttr::variant>& variants) {
+template<typename T>
+size_t count() {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
-    bool has_t = false;
-    for (const auto& variant : variants) {
-        if (variant.get_type() == rttr::type::get<T>()) {
-            has_t = true;
-            break;
-        }
-    }
+    const VariantPool* pool = Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value);
     
-    if (!has_t) {
-        return false;
+    return pool ? pool->size() : 0;
+}
+
+template<typename T, typename Action>
+void for_each(Action&& action) {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+    VariantPool* pool = Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value);
+
+    if (!pool) {
+        return;
     }
     
-    if constexpr (sizeof...(Rest) > 0) {
-        return has_types<Rest...>(variants);
+    for (size_t i = 0; i < pool->size(); i++) {
+        T& component = *static_cast<T*>(pool->get_variants()[i]);
+        action(component);
     }
-    
-    return true;
 }
 
-template<typename T>
-size_t count() {
+// Runs action on every variant of T across the job system and returns once all
+// of them ran. action must not add or remove variants or entities.
+template<typename T, typename Action>
+void par_for_each(Action&& action, size_t min_chunk = 64) {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
-    size_t count = 0;
-    const rttr::type& type = rttr::type::get<T>();
-    
-    for (auto& [entity_id, variants] : Zeytin::get().get_storage()) {
-        for (auto& variant : variants) {
-            if (variant.get_type() == type) {
-                count++;
-                break;
-            }
-        }
+    VariantPool* pool = Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value);
+
+    if (!pool) {
+        return;
     }
-    
-    return count;
+
+    VariantBase* const* variants = pool->get_variants().data();
+    JobSystem::get().parallel_for(pool->size(), min_chunk, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            action(*static_cast<T*>(variants[i]));
+        }
+    });
 }
 
-template<typename T>
-void for_each(std::function<void(T&)> action) {
+// Like par_for_each, but hands each job a contiguous VariantRange<T> chunk of the pool.
+template<typename T, typename Action>
+void par_for_chunk(Action&& action, size_t min_chunk = 64) {
     static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
-    const rttr::type& type = rttr::type::get<T>();
-    
-    for (auto& [entity_id, variants] : Zeytin::get().get_storage()) {
-        for (auto& variant : variants) {
-            if (variant.get_type() == type) {
-                T& component = variant.get_value<T&>();
-                action(component);
-            }
-        }
+    VariantPool* pool = Zeytin::get().get_storage().find_pool(VariantTypeIndex<T>::value);
+
+    if (!pool) {
+        return;
     }
+
+    VariantBase* const* variants = pool->get_variants().data();
+    JobSystem::get().parallel_for(pool->size(), min_chunk, [&](size_t begin, size_t end) {
+        action(VariantRange<T>(variants + begin, variants + end));
+    });
 }
 
 template<typename T>
 void remove_variant_from(entity_id id) {
-    Zeytin::get().remove_variant(id, rttr::type::get<T>());
+    Zeytin::get().remove_variant(id, VariantTypeIndex<T>::value);
 }
 
 template<typename T>
 void remove_variant_from(const VariantBase* base) {
-    Zeytin::get().remove_variant(base->entity_id, rttr::type::get<T>());
+    Zeytin::get().remove_variant(base->entity_id, VariantTypeIndex<T>::value);
+}
+
+// Creates count entities with a default-constructed Ts... each, built in place in
+// their pools after reserving every pool once for the whole batch. setup is called
+// as setup(i, entity_id, Ts&...) to fill in the i-th entity before its variants'
+// on_init runs. Like add, this changes the pools right away, so it must not run
+// while pools are iterated, which includes every lifecycle hook (on_play_start,
+// on_play_update, ...); use commands().spawn_batch there.
+template<typename... Ts, typename F>
+std::vector<entity_id> spawn_batch(size_t count, F&& setup) {
+    static_assert(sizeof...(Ts) > 0, "spawn_batch needs at least one variant type");
+    static_assert((std::is_base_of<VariantBase, Ts>::value && ...), "Ts must derive from VariantBase");
+    VariantStorage& storage = Zeytin::get().get_storage();
+
+    if (count > 1 && (is_singleton_variant_v<Ts> || ...)) {
+        log_error() << "Cannot spawn a batch of " << count << " entities with a singleton variant" << std::endl;
+        return {};
+    }
+
+    ([&] {
+        VariantPool& pool = storage.get_pool(VariantTypeIndex<Ts>::value);
+        pool.reserve(pool.size() + count);
+    }(), ...);
+
+    std::vector<entity_id> ids = storage.create_entities(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const entity_id id = ids[i];
+
+        // braced, so the variants are emplaced in the order of Ts
+        std::tuple<Ts&...> variants{ *static_cast<Ts*>(storage.emplace_variant(id, VariantTypeIndex<Ts>::value))... };
+
+        std::apply([&](Ts&... variant) {
+            setup(i, id, variant...);
+
+            (storage.get_pool(VariantTypeIndex<Ts>::value).reset_previous(id), ...);
+            (variant.on_init(), ...);
+        }, variants);
+    }
+
+    return ids;
 }
 
 template<typename T, typename... Args>
@@ -274,12 +432,15 @@ std::optional<std::reference_wrapper<T>> add(entity_id id, Args&&... args) {
 
     T variant(std::forward<Args>(args)...);
     variant.entity_id = id;
-    variant.on_init();
-    
-    auto& variants = Zeytin::get().get_variants(id);
-    variants.push_back(std::move(variant));
 
-    return std::ref(Query::get<T>(id));
+    // moved into the pool's arena first, so on_init sees the instance's final address
+    VariantBase* stored = Zeytin::get().get_storage().add_variant(id, VariantTypeIndex<T>::value, variant);
+    if (!stored) {
+        return std::nullopt;
+    }
+
+    stored->on_init();
+    return std::ref(*static_cast<T*>(stored));
 }
 
 template<typename T, typename... Args>
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include "entity/entity.h"
+#include "variant/variant_type.h"
+#include "core/storage/variant_arena.h"
+
+struct VariantBase;
+class VariantStorage;
+
+// Records structural changes (entity creation, variant add/remove, entity
+// destruction) so they can be made while pools are being iterated. Zeytin applies
+// them, in the order they were recorded, at the sync points of run_frame.
+// Recording is thread-safe, so jobs may record as well.
+class CommandBuffer {
+public:
+    explicit CommandBuffer(VariantStorage& storage);
+    ~CommandBuffer();
+
+    // The handle is reserved right away so variants can be recorded for it, without
+    // touching the storage that jobs read; the entity comes alive, with no variants,
+    // when the buffer is applied.
+    entity_id create_entity();
+
+    // The variant is built now, in a staging arena owned by the buffer, and can be
+    // set up through the returned reference until the buffer is applied. Applying
+    // moves it into its pool and calls on_init on the pooled instance.
+    template<typename T, typename... Args>
+    T& add(entity_id id, Args&&... args) {
+        static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+        constexpr variant_type_index index = VariantTypeIndex<T>::value;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        T* variant = new (get_staging(index).allocate()) T(std::forward<Args>(args)...);
+        variant->entity_id = id;
+
+        m_commands.push_back(Command{ CommandType::Add, id, index, variant });
+        return *variant;
+    }
+
+    // Reserves count entities and builds a default-constructed Ts... for each in
+    // the staging arenas. setup is called as setup(i, entity_id, Ts&...) on the
+    // staged variants right away, outside the lock, so it may record as well.
+    // Applying creates the entities and moves the variants in, growing each pool
+    // once for the whole buffer.
+    template<typename... Ts, typename F>
+    std::vector<entity_id> spawn_batch(size_t count, F&& setup) {
+        static_assert(sizeof...(Ts) > 0, "spawn_batch needs at least one variant type");
+        static_assert((std::is_base_of<VariantBase, Ts>::value && ...), "Ts must derive from VariantBase");
+
+        if (!can_spawn_batch(count, (is_singleton_variant_v<Ts> || ...))) {
+            return {};
+        }
+
+        std::vector<entity_id> ids(count);
+        std::vector<std::tuple<Ts*...>> staged(count);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = 0; i < count; i++) {
+                ids[i] = record_create();
+
+                // braced, so the variants are staged and added in the order of Ts
+                staged[i] = std::tuple<Ts*...>{ stage<Ts>(ids[i])... };
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            std::apply([&](Ts*... variant) { setup(i, ids[i], *variant...); }, staged[i]);
+        }
+
+        return ids;
+    }
+
+    template<typename T>
+    void remove(entity_id id) {
+        static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+        remove(id, VariantTypeIndex<T>::value);
+    }
+
+    void remove(entity_id id, variant_type_index index);
+    void destroy(entity_id id);
+
+    // Commands recorded while applying (e.g. from on_init) are kept for the next sync point.
+    void apply();
+    void clear();
+
+    bool empty() const;
+
+private:
+    enum class CommandType {
+        Create,
+        Add,
+        Remove,
+        Destroy
+    };
+
+    struct Command {
+        CommandType type;
+        entity_id id;
+        variant_type_index index;
+        VariantBase* variant;
+    };
+
+    void record(CommandType type, entity_id id, variant_type_index index);
+    // Logs and returns false for a batch of more than one entity with a singleton variant.
+    bool can_spawn_batch(size_t count, bool has_singleton) const;
+
+    // These expect m_mutex to be held.
+    entity_id record_create();
+    template<typename T>
+    T* stage(entity_id id) {
+        constexpr variant_type_index index = VariantTypeIndex<T>::value;
+
+        T* variant = new (get_staging(index).allocate()) T();
+        variant->entity_id = id;
+
+        m_commands.push_back(Command{ CommandType::Add, id, index, variant });
+        return variant;
+    }
+
+    VariantArena& get_staging(variant_type_index index);
+    void release_staged(const Command& command);
+
+    VariantStorage& m_storage;
+
+    mutable std::mutex m_mutex;
+    std::vector<Command> m_commands;
+    // one arena per variant type, reused across frames
+    std::vector<std::unique_ptr<VariantArena>> m_staging;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "variant/variant_type.h"
+
+struct VariantBase;
+
+// Per-type slab allocator for pooled variants. Objects are carved out of
+// fixed-size slabs and never move, freed objects go to an intrusive free list,
+// and release() hands every slab back at once. Not thread-safe; pools are only
+// grown on the main thread (directly or when a CommandBuffer is applied).
+class VariantArena {
+public:
+    VariantArena(size_t size, size_t alignment);
+    ~VariantArena();
+
+    VariantArena(const VariantArena&) = delete;
+    VariantArena& operator=(const VariantArena&) = delete;
+
+    void* allocate();
+    void deallocate(void* memory);
+
+    // Makes sure the next count allocations do not need more than one new slab.
+    void reserve(size_t count);
+
+    // Frees every slab. Objects still living in the arena must have been destroyed.
+    void release();
+
+    inline size_t get_stride() const { return m_stride; }
+    inline size_t get_slab_count() const { return m_slabs.size(); }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    void add_slab(size_t count);
+
+    size_t m_stride;
+    size_t m_alignment;
+    size_t m_slab_capacity;
+
+    std::vector<void*> m_slabs;
+    std::byte* m_cursor = nullptr;
+    std::byte* m_end = nullptr;
+    FreeNode* m_free = nullptr;
+};
+
+constexpr size_t MAX_SOA_FIELDS = 4;
+
+// What a pool needs to know about its concrete variant type to keep instances
+// in an arena. destroy is nullptr for trivially destructible types, so clearing
+// their pools does not touch the instances at all.
+// SOA() types also list their float fields, for the integration pass and the
+// previous-step copies the pool keeps for interpolation.
+struct VariantTypeOps {
+    size_t size;
+    size_t alignment;
+    VariantBase* (*default_construct)(void* memory);
+    VariantBase* (*move_construct)(void* memory, VariantBase& source);
+    void (*destroy)(VariantBase* instance);
+
+    size_t soa_field_count;
+    float VariantBase::* soa_fields[MAX_SOA_FIELDS];
+};
+
+template<typename T, typename... Fields>
+constexpr VariantTypeOps make_variant_type_ops(Fields... fields) {
+    static_assert(sizeof...(Fields) <= MAX_SOA_FIELDS, "too many SOA() fields");
+
+    return VariantTypeOps{
+        sizeof(T),
+        alignof(T),
+        [](void* memory) -> VariantBase* {
+            return new (memory) T();
+        },
+        [](void* memory, VariantBase& source) -> VariantBase* {
+            return new (memory) T(std::move(static_cast<T&>(source)));
+        },
+        std::is_trivially_destructible<T>::value ? nullptr : +[](VariantBase* instance) {
+            static_cast<T*>(instance)->~T();
+        },
+        sizeof...(Fields),
+        { static_cast<float VariantBase::*>(fields)... }
+    };
+}
+
+// Generated by scripts/parser2.py into game/generated/variant_ops.h.
+const VariantTypeOps& get_variant_type_ops(variant_type_index index);
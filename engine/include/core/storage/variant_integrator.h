@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+class VariantPool;
+class VariantStorage;
+
+// Runs the INTEGRATE_INTO() pairs once per fixed step: for every entity owning
+// both variants alive, each target field gets the matching source field times
+// the step's dt added. Other target slots are not written. Works straight on the
+// instances, in chunks of the target pool spread over the job system.
+class VariantIntegrator {
+public:
+    void run(VariantStorage& storage, float dt);
+
+private:
+    void integrate(VariantPool& target, const VariantPool& source, float dt, uint32_t tick);
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "rttr/type.h"
+#include "entity/entity.h"
+#include "variant/variant_type.h"
+#include "core/storage/variant_arena.h"
+
+// Holds every variant of a single type. The instances live in the pool's
+// VariantArena and never move; m_variants is the dense array of their addresses.
+// m_sparse maps an entity index to its slot, m_entities maps a slot back to its entity.
+// A slot only matches a handle of the same generation, so stale handles find nothing.
+// Every slot also records the world tick it was added at and last written at, for
+// change detection (Query::added / Query::changed).
+// Erasing swaps the last slot into the hole so the dense arrays never have gaps.
+class VariantPool {
+public:
+    VariantPool(variant_type_index index, const rttr::type& type, const VariantTypeOps& ops)
+        : m_index(index), m_type(type), m_ops(ops), m_arena(ops.size, ops.alignment), m_previous(ops.soa_field_count) {}
+    ~VariantPool();
+
+    VariantPool(const VariantPool&) = delete;
+    VariantPool& operator=(const VariantPool&) = delete;
+
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+    bool contains(entity_id id) const;
+
+    VariantBase* find(entity_id id);
+    const VariantBase* find(entity_id id) const;
+
+    // Like find, but stamps the slot as changed at tick.
+    VariantBase* find_for_write(entity_id id, uint32_t tick);
+
+    // Move-constructs a copy of variant in the arena; variant must be of the pool's type.
+    VariantBase* insert(entity_id id, VariantBase& variant, uint32_t tick);
+    // Default-constructs the variant in the arena, for callers that set it up in place.
+    VariantBase* emplace(entity_id id, uint32_t tick);
+
+    void erase(entity_id id);
+
+    void reserve(size_t capacity);
+    // Gives memory back once the pool has shrunk to a quarter of its capacity,
+    // and frees the arena once the pool is empty.
+    void compact();
+    // Destroys every instance and frees the whole arena.
+    void clear();
+
+    inline size_t size() const { return m_variants.size(); }
+    inline size_t capacity() const { return m_variants.capacity(); }
+    inline bool empty() const { return m_variants.empty(); }
+    inline variant_type_index get_type_index() const { return m_index; }
+    inline const rttr::type& get_type() const { return m_type; }
+
+    inline const std::vector<VariantBase*>& get_variants() const { return m_variants; }
+    inline const std::vector<entity_id>& get_entities() const { return m_entities; }
+    inline const std::vector<uint32_t>& get_added_ticks() const { return m_added_ticks; }
+    inline const std::vector<uint32_t>& get_changed_ticks() const { return m_changed_ticks; }
+
+    inline void mark_changed(size_t slot, uint32_t tick) { m_changed_ticks[slot] = tick; }
+
+    // Number of float fields of an SOA() type, 0 for other types.
+    inline size_t get_soa_field_count() const { return m_ops.soa_field_count; }
+    inline float VariantBase::* get_soa_field(size_t field) const { return m_ops.soa_fields[field]; }
+
+    // SOA() types remember their fields as they were before the current fixed
+    // step, so rendering can draw them part way between two steps.
+    void save_previous();
+    // Blends the SOA() fields of out from id's previous values to its current ones.
+    void interpolate(entity_id id, float alpha, VariantBase& out) const;
+    // Takes id's current SOA() fields as its previous ones, for a variant that was
+    // set up after emplace and should not be drawn moving in from its defaults.
+    void reset_previous(entity_id id);
+
+private:
+    uint32_t find_slot(entity_id id) const;
+    VariantBase* push(entity_id id, VariantBase* instance, uint32_t tick);
+    void destroy(VariantBase* instance);
+
+    variant_type_index m_index;
+    rttr::type m_type;
+    const VariantTypeOps& m_ops;
+    VariantArena m_arena;
+
+    std::vector<VariantBase*> m_variants;
+    std::vector<entity_id> m_entities;
+    std::vector<uint32_t> m_added_ticks;
+    std::vector<uint32_t> m_changed_ticks;
+    std::vector<uint32_t> m_sparse;
+    std::vector<std::vector<float>> m_previous;
+};
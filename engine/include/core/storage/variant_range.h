@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <iterator>
+
+#include "core/storage/variant_pool.h"
+
+struct VariantBase;
+
+// Lazy, allocation-free views over a VariantPool. They read the pool in place,
+// so adding variants of the same type while iterating invalidates them; use
+// Query::for_each for loops that spawn.
+template<typename T>
+class VariantIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    VariantIterator() = default;
+    explicit VariantIterator(VariantBase* const* current) : m_current(current) {}
+
+    inline T& operator*() const { return *static_cast<T*>(*m_current); }
+    inline T* operator->() const { return static_cast<T*>(*m_current); }
+
+    inline VariantIterator& operator++() { ++m_current; return *this; }
+    inline VariantIterator operator++(int) { VariantIterator tmp = *this; ++m_current; return tmp; }
+
+    inline bool operator==(const VariantIterator& other) const { return m_current == other.m_current; }
+    inline bool operator!=(const VariantIterator& other) const { return m_current != other.m_current; }
+
+private:
+    VariantBase* const* m_current = nullptr;
+};
+
+template<typename T>
+class VariantRange {
+public:
+    using iterator = VariantIterator<T>;
+
+    explicit VariantRange(VariantPool* pool) {
+        if (pool && !pool->empty()) {
+            m_begin = pool->get_variants().data();
+            m_end = m_begin + pool->size();
+        }
+    }
+
+    VariantRange(VariantBase* const* begin, VariantBase* const* end) : m_begin(begin), m_end(end) {}
+
+    inline iterator begin() const { return iterator(m_begin); }
+    inline iterator end() const { return iterator(m_end); }
+
+    inline size_t size() const { return static_cast<size_t>(m_end - m_begin); }
+    inline bool empty() const { return m_begin == m_end; }
+
+private:
+    VariantBase* const* m_begin = nullptr;
+    VariantBase* const* m_end = nullptr;
+};
+
+template<typename T, typename Predicate>
+class FilteredVariantRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator() = default;
+        iterator(VariantBase* const* current, VariantBase* const* end, const Predicate* predicate)
+            : m_current(current), m_end(end), m_predicate(predicate) {
+            skip();
+        }
+
+        inline T& operator*() const { return *static_cast<T*>(*m_current); }
+        inline T* operator->() const { return static_cast<T*>(*m_current); }
+
+        inline iterator& operator++() { ++m_current; skip(); return *this; }
+        inline iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+
+        inline bool operator==(const iterator& other) const { return m_current == other.m_current; }
+        inline bool operator!=(const iterator& other) const { return m_current != other.m_current; }
+
+    private:
+        inline void skip() {
+            while (m_current != m_end && !(*m_predicate)(*static_cast<T*>(*m_current))) {
+                ++m_current;
+            }
+        }
+
+        VariantBase* const* m_current = nullptr;
+        VariantBase* const* m_end = nullptr;
+        const Predicate* m_predicate = nullptr;
+    };
+
+    FilteredVariantRange(VariantPool* pool, Predicate predicate) : m_predicate(std::move(predicate)) {
+        if (pool && !pool->empty()) {
+            m_begin = pool->get_variants().data();
+            m_end = m_begin + pool->size();
+        }
+    }
+
+    inline iterator begin() const { return iterator(m_begin, m_end, &m_predicate); }
+    inline iterator end() const { return iterator(m_end, m_end, &m_predicate); }
+
+    inline bool empty() const { return begin() == end(); }
+
+private:
+    VariantBase* const* m_begin = nullptr;
+    VariantBase* const* m_end = nullptr;
+    Predicate m_predicate;
+};
+
+// Variants of a pool whose tick (added or last written, see VariantPool) is at or after since.
+template<typename T>
+class TickFilteredVariantRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator() = default;
+        iterator(VariantBase* const* variants, const uint32_t* ticks, size_t current, size_t end, uint32_t since)
+            : m_variants(variants), m_ticks(ticks), m_current(current), m_end(end), m_since(since) {
+            skip();
+        }
+
+        inline T& operator*() const { return *static_cast<T*>(m_variants[m_current]); }
+        inline T* operator->() const { return static_cast<T*>(m_variants[m_current]); }
+
+        inline iterator& operator++() { ++m_current; skip(); return *this; }
+        inline iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+
+        inline bool operator==(const iterator& other) const { return m_current == other.m_current; }
+        inline bool operator!=(const iterator& other) const { return m_current != other.m_current; }
+
+    private:
+        inline void skip() {
+            // wrap-safe "m_ticks[m_current] >= m_since"
+            while (m_current != m_end && static_cast<int32_t>(m_ticks[m_current] - m_since) < 0) {
+                ++m_current;
+            }
+        }
+
+        VariantBase* const* m_variants = nullptr;
+        const uint32_t* m_ticks = nullptr;
+        size_t m_current = 0;
+        size_t m_end = 0;
+        uint32_t m_since = 0;
+    };
+
+    TickFilteredVariantRange(VariantPool* pool, const std::vector<uint32_t>* ticks, uint32_t since) : m_since(since) {
+        if (pool && !pool->empty()) {
+            m_variants = pool->get_variants().data();
+            m_ticks = ticks->data();
+            m_size = pool->size();
+        }
+    }
+
+    inline iterator begin() const { return iterator(m_variants, m_ticks, 0, m_size, m_since); }
+    inline iterator end() const { return iterator(m_variants, m_ticks, m_size, m_size, m_since); }
+
+    inline bool empty() const { return begin() == end(); }
+
+private:
+    VariantBase* const* m_variants = nullptr;
+    const uint32_t* m_ticks = nullptr;
+    size_t m_size = 0;
+    uint32_t m_since = 0;
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <typeindex>
+
+#include "rttr/variant.h"
+#include "entity/entity.h"
+#include "entity/entity_registry.h"
+#include "variant/variant_type.h"
+#include "core/storage/variant_pool.h"
+#include "core/storage/variant_view.h"
+
+struct VariantBase;
+
+// World storage: one VariantPool per variant type, the entity registry, plus the
+// list of types each entity owns so that per-entity paths (serialization, editor) keep working.
+// Pools are addressed by variant_type_index; the rttr::type overloads exist for
+// the editor and serialization, which only know the type at runtime.
+class VariantStorage {
+public:
+    VariantStorage();
+
+    VariantPool& get_pool(variant_type_index index);
+
+    inline VariantPool* find_pool(variant_type_index index) {
+        return index < m_pools.size() ? m_pools[index].get() : nullptr;
+    }
+
+    inline const VariantPool* find_pool(variant_type_index index) const {
+        return index < m_pools.size() ? m_pools[index].get() : nullptr;
+    }
+
+    inline VariantPool* find_pool(const rttr::type& type) { return find_pool(get_variant_type_index(type)); }
+    inline const VariantPool* find_pool(const rttr::type& type) const { return find_pool(get_variant_type_index(type)); }
+
+    // All of them move the variant into its pool's arena and return the stored
+    // instance, or nullptr when the entity is not alive, when a SINGLETON() type
+    // already has an instance, or (rttr overload) when the type is no variant.
+    VariantBase* add_variant(entity_id id, variant_type_index index, VariantBase& variant);
+    VariantBase* add_variant(entity_id id, variant_type_index index, rttr::variant&& variant);
+    VariantBase* add_variant(entity_id id, rttr::variant&& variant);
+    // Same checks, but the variant is default-constructed in place in its pool.
+    VariantBase* emplace_variant(entity_id id, variant_type_index index);
+
+    inline VariantBase* find_variant(entity_id id, variant_type_index index) {
+        VariantPool* pool = find_pool(index);
+        return pool ? pool->find(id) : nullptr;
+    }
+
+    inline const VariantBase* find_variant(entity_id id, variant_type_index index) const {
+        const VariantPool* pool = find_pool(index);
+        return pool ? pool->find(id) : nullptr;
+    }
+
+    // Like find_variant, but marks the variant as changed this tick.
+    inline VariantBase* find_variant_for_write(entity_id id, variant_type_index index) {
+        VariantPool* pool = find_pool(index);
+        return pool ? pool->find_for_write(id, m_tick) : nullptr;
+    }
+
+    // The instance of a SINGLETON() type, or nullptr.
+    inline VariantBase* find_singleton(variant_type_index index) const { return m_singletons[index]; }
+
+    inline bool has_variant(entity_id id, variant_type_index index) const {
+        return index < VARIANT_TYPE_COUNT && ((get_mask(id) >> index) & 1) != 0;
+    }
+
+    // Bit set of the variant types the entity owns, 0 for dead or stale handles.
+    inline variant_mask get_mask(entity_id id) const {
+        return m_registry.is_alive(id) ? m_entity_masks[get_entity_index(id)] : 0;
+    }
+
+    inline bool has_variants(entity_id id, variant_mask mask) const {
+        return (get_mask(id) & mask) == mask;
+    }
+
+    inline VariantBase* find_variant(entity_id id, const rttr::type& type) { return find_variant(id, get_variant_type_index(type)); }
+    inline bool has_variant(entity_id id, const rttr::type& type) const { return has_variant(id, get_variant_type_index(type)); }
+
+    std::vector<VariantBase*> get_variants(entity_id id);
+
+    entity_id create_entity();
+    entity_id create_entity(entity_guid guid);
+    // Creates count entities, growing the per-entity tables once for all of them.
+    std::vector<entity_id> create_entities(size_t count);
+    // Thread-safe, see EntityRegistry::reserve. The entity exists once create_reserved_entity ran.
+    inline entity_id reserve_entity() { return m_registry.reserve(); }
+    bool create_reserved_entity(entity_id id);
+    inline bool has_entity(entity_id id) const { return m_registry.is_alive(id); }
+
+    inline entity_guid get_guid(entity_id id) { return m_registry.get_guid(id); }
+    inline entity_id find_entity(entity_guid guid) const { return m_registry.find(guid); }
+
+    void remove_variant(entity_id id, variant_type_index index);
+    void remove_entity(entity_id id);
+
+    inline void remove_variant(entity_id id, const rttr::type& type) { remove_variant(id, get_variant_type_index(type)); }
+
+    void clear();
+
+    // Snapshots the SOA() fields of every pool, see VariantPool::save_previous.
+    void save_previous();
+
+    // The world tick advances once per frame; pools stamp adds and writes with it.
+    inline uint32_t get_tick() const { return m_tick; }
+    inline void advance_tick() { m_tick++; }
+
+    // Views are created on first request and live as long as the storage.
+    template<typename View>
+    View& get_view() {
+        auto it = m_view_lookup.find(std::type_index(typeid(View)));
+        if (it != m_view_lookup.end()) {
+            return static_cast<View&>(*it->second);
+        }
+
+        auto view = std::make_unique<View>();
+        View& result = *view;
+        register_view(std::move(view));
+        return result;
+    }
+
+    inline const std::vector<std::unique_ptr<VariantPool>>& get_pools() const { return m_pools; }
+    inline const EntityRegistry& get_registry() const { return m_registry; }
+
+private:
+    void register_view(std::unique_ptr<VariantViewBase> view);
+
+    // Shared by add_variant and emplace_variant: the pool to add to, or nullptr
+    // when the add is not allowed, and the bookkeeping once the variant is stored.
+    VariantPool* prepare_add(entity_id id, variant_type_index index);
+    VariantBase* finish_add(entity_id id, variant_type_index index, VariantBase* stored);
+
+    // One slot per variant type, created on first use. Slots are never destroyed or
+    // reordered while the world is alive, so lifecycle passes can walk them by index
+    // while variants add new pools.
+    std::vector<std::unique_ptr<VariantPool>> m_pools;
+
+    uint32_t m_tick = 1;
+
+    std::vector<VariantBase*> m_singletons;
+
+    EntityRegistry m_registry;
+    // indexed by entity index, valid while the entity is alive
+    std::vector<std::vector<variant_type_index>> m_entity_types;
+    std::vector<variant_mask> m_entity_masks;
+
+    std::unordered_map<std::type_index, std::unique_ptr<VariantViewBase>> m_view_lookup;
+    std::vector<std::vector<VariantViewBase*>> m_type_views;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include "entity/entity.h"
+#include "variant/variant_type.h"
+
+struct VariantBase;
+class VariantStorage;
+
+// Persistent list of every entity owning all of a set of variant types. The
+// storage keeps it up to date as variants are added and removed, so iterating a
+// view costs only as much as the entities that match.
+// Each row caches the matched variants' addresses; pooled variants live in their
+// pool's arena and never move, so the addresses survive pool growth and swap-removal.
+class VariantViewBase {
+public:
+    explicit VariantViewBase(std::vector<variant_type_index> indices) : m_indices(std::move(indices)) {
+        for (variant_type_index index : m_indices) {
+            m_mask |= variant_mask(1) << index;
+        }
+    }
+    virtual ~VariantViewBase() = default;
+
+    void build(VariantStorage& storage);
+    void on_variant_added(VariantStorage& storage, entity_id id);
+    void on_variant_removed(entity_id id);
+    void clear();
+
+    inline bool contains(entity_id id) const { return find_row(id) != INVALID_ROW; }
+    inline size_t size() const { return m_entities.size(); }
+    inline bool empty() const { return m_entities.empty(); }
+
+    inline const std::vector<variant_type_index>& get_type_indices() const { return m_indices; }
+    inline const std::vector<entity_id>& get_entities() const { return m_entities; }
+
+protected:
+    inline VariantBase* const* get_row(size_t row) const { return &m_rows[row * m_indices.size()]; }
+
+private:
+    static constexpr uint32_t INVALID_ROW = UINT32_MAX;
+
+    inline uint32_t find_row(entity_id id) const {
+        const uint32_t index = get_entity_index(id);
+        if (index >= m_sparse.size() || m_sparse[index] == INVALID_ROW || m_entities[m_sparse[index]] != id) {
+            return INVALID_ROW;
+        }
+
+        return m_sparse[index];
+    }
+
+    std::vector<variant_type_index> m_indices;
+    variant_mask m_mask = 0;
+
+    std::vector<entity_id> m_entities;
+    std::vector<VariantBase*> m_rows;
+    std::vector<uint32_t> m_sparse;
+};
+
+template<typename... Ts>
+class VariantView : public VariantViewBase {
+public:
+    VariantView() : VariantViewBase({ VariantTypeIndex<Ts>::value... }) {}
+
+    // fn is called as fn(Ts&...) for every matching entity.
+    template<typename F>
+    void each(F&& fn) const {
+        for (size_t row = 0; row < size(); row++) {
+            invoke(fn, get_row(row), std::index_sequence_for<Ts...>{});
+        }
+    }
+
+    // fn is called as fn(entity_id, Ts&...) for every matching entity.
+    template<typename F>
+    void each_with_id(F&& fn) const {
+        for (size_t row = 0; row < size(); row++) {
+            invoke(fn, get_entities()[row], get_row(row), std::index_sequence_for<Ts...>{});
+        }
+    }
+
+private:
+    template<typename F, size_t... Is>
+    static void invoke(F& fn, VariantBase* const* row, std::index_sequence<Is...>) {
+        fn(*static_cast<Ts*>(row[Is])...);
+    }
+
+    template<typename F, size_t... Is>
+    static void invoke(F& fn, entity_id id, VariantBase* const* row, std::index_sequence<Is...>) {
+        fn(id, *static_cast<Ts*>(row[Is])...);
+    }
+};
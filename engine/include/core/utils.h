@@ -4,12 +4,13 @@
 #include <string>
 
 #include "rttr/variant.h"
+#include "rttr/instance.h"
 
 #include "remote_logger/remote_logger.h"
 
 namespace {
     template<typename T>
-    void update_property(rttr::variant& obj, const std::vector<std::string>& path_parts, 
+    void update_property(rttr::instance obj, const std::vector<std::string>& path_parts, 
                          size_t path_index, const T& value) {
         if (path_index >= path_parts.size()) {
             return; 
@@ -18,7 +19,7 @@ namespace {
         const std::string& current_path = path_parts[path_index];
 
         if (path_index == path_parts.size() - 1) {
-            for (auto& property : obj.get_type().get_properties()) {
+            for (auto& property : obj.get_derived_type().get_properties()) {
                 if (property.get_name() == current_path) {
                     property.set_value(obj, value);
 
@@ -32,7 +33,7 @@ namespace {
                     std::string set_callback_name = callback.to_string();
 
                     //std::string set_callback_name = "on_" + property.get_name().to_string() + "_set";
-                    rttr::method set_callback = obj.get_type().get_method(set_callback_name);;
+                    rttr::method set_callback = obj.get_derived_type().get_method(set_callback_name);;
                     if(set_callback.is_valid()) {
                         set_callback.invoke(obj);
                     }
@@ -41,7 +42,7 @@ namespace {
                 }
             }
         } else {
-            for (auto& property : obj.get_type().get_properties()) {
+            for (auto& property : obj.get_derived_type().get_properties()) {
                 if (property.get_name() == current_path) {
                     rttr::variant nested_obj = property.get_value(obj);
                     update_property(nested_obj, path_parts, path_index + 1, value);
@@ -64,6 +65,25 @@ namespace {
 
         return path_parts;
     }
+
+    // Splits a comma separated list, trimming spaces and dropping empty entries.
+    std::vector<std::string> split_list(const std::string& list) {
+        std::vector<std::string> parts;
+        std::string current_part;
+        std::istringstream list_stream(list);
+
+        while (std::getline(list_stream, current_part, ',')) {
+            const size_t begin = current_part.find_first_not_of(' ');
+            if (begin == std::string::npos) {
+                continue;
+            }
+
+            const size_t end = current_part.find_last_not_of(' ');
+            parts.push_back(current_part.substr(begin, end - begin + 1));
+        }
+
+        return parts;
+    }
 }
 
 
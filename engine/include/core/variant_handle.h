@@ -0,0 +1,34 @@
+#pragma once
+
+#include <type_traits>
+
+#include "core/zeytin.h"
+#include "entity/entity.h"
+#include "variant/variant_base.h"
+#include "variant/variant_type.h"
+
+// Weak reference to the T of an entity. Pooled variants never move while they
+// live, so holding a T& or capturing this is fine for as long as the variant
+// does; a handle is for callbacks and caches that may outlive it. resolve()
+// returns nullptr once the variant was removed or its entity destroyed.
+template<typename T>
+class VariantHandle {
+    static_assert(std::is_base_of<VariantBase, T>::value, "T must derive from VariantBase");
+
+public:
+    VariantHandle() = default;
+    explicit VariantHandle(entity_id id) : m_id(id) {}
+    explicit VariantHandle(const T& variant) : m_id(variant.entity_id) {}
+
+    inline T* resolve() const {
+        VariantBase* variant = Zeytin::get().get_storage().find_variant(m_id, VariantTypeIndex<T>::value);
+        return variant && !variant->is_dead ? static_cast<T*>(variant) : nullptr;
+    }
+
+    inline explicit operator bool() const { return resolve() != nullptr; }
+
+    inline entity_id get_entity() const { return m_id; }
+
+private:
+    entity_id m_id = INVALID_ENTITY;
+};
@@ -14,6 +14,11 @@
 #include "editor/editor_communication.h"
 
 #include "core/macros.h"
+#include "core/storage/variant_storage.h"
+#include "core/storage/command_buffer.h"
+#include "core/storage/variant_integrator.h"
+#include "core/jobs/job_system.h"
+#include "core/jobs/variant_scheduler.h"
 
 constexpr float VIRTUAL_WIDTH = 1920;
 constexpr float VIRTUAL_HEIGHT = 1080;
@@ -27,11 +32,14 @@ public:
 
     entity_id new_entity_id();
     
+    // Removal is deferred: the variants are marked dead right away, so the update
+    // passes skip them, and reclaimed by reclaim_dead_variants at the end of the frame.
+    void remove_variant(entity_id id, variant_type_index index);
     void remove_variant(entity_id id, const rttr::type& type);
     void remove_entity(entity_id id);
     
-    void clean_dead_variants();
-    std::vector<rttr::variant>& get_variants(const entity_id& entity);
+    void reclaim_dead_variants();
+    std::vector<VariantBase*> get_variants(const entity_id& entity);
 
     std::string zserialize_entity(const entity_id id);
     std::string zserialize_entity(const entity_id id, const std::filesystem::path& path);
@@ -49,8 +57,21 @@ public:
     void play_update_variants();
 
     inline Camera2D& get_camera() { return m_camera; }
-    inline const std::unordered_map<entity_id, std::vector<rttr::variant>>& get_storage() const { return m_storage; }
-    inline std::unordered_map<entity_id, std::vector<rttr::variant>>& get_storage() { return m_storage; }
+
+    // Play updates run in fixed steps of 1 / tick_rate seconds, whatever the frame rate.
+    inline float get_fixed_delta() const { return m_fixed_delta; }
+    // How far rendering is between the last two fixed steps, in [0, 1]; 1 outside play mode.
+    inline float get_interpolation_alpha() const { return m_interpolation_alpha; }
+    // Always true in standalone builds.
+    inline bool is_play_mode() const { return m_is_play_mode; }
+    inline bool is_paused_play_mode() const { return m_is_pause_play_mode; }
+
+    // Jobs submitted to this group may run across the frame; they are all joined before rendering.
+    inline JobGroup& get_frame_jobs() { return m_frame_jobs; }
+    // Structural changes recorded here are applied at the sync points of run_frame.
+    inline CommandBuffer& get_commands() { return m_commands; }
+    inline const VariantStorage& get_storage() const { return m_storage; }
+    inline VariantStorage& get_storage() { return m_storage; }
 
 #ifdef EDITOR_MODE
     void generate_variants();
@@ -68,8 +89,6 @@ public:
     void handle_entity_variant_removed(const rapidjson::Document& msg);
     void handle_entity_removed(const rapidjson::Document& msg);
     
-    inline bool is_play_mode() const { return m_is_play_mode; }
-    inline bool is_paused_play_mode() const { return m_is_pause_play_mode; }
     inline bool is_scene_ready() const { return m_is_scene_ready; }
 
     bool m_synced_once = false;
@@ -82,16 +101,33 @@ private:
     void initialize_camera();
     void update_camera();
     void render();
+
+    void play_update_pool(variant_type_index index);
+    void run_fixed_steps(float frame_time);
+    void apply_commands();
     
     bool m_started = false;
     bool m_late_started = false;
     bool m_should_die = false;
+    bool m_parallel_play_update = false;
+
+    float m_fixed_delta = 1.0f / 60.0f;
+    int m_max_substeps = 5;
+    float m_accumulator = 0.0f;
+    float m_interpolation_alpha = 1.0f;
 
     bool m_is_scene_ready = false;
     bool m_is_play_mode = false;
     bool m_is_pause_play_mode = false;
 
-    std::unordered_map<entity_id, std::vector<rttr::variant>> m_storage;
+    VariantStorage m_storage;
+    JobGroup m_frame_jobs;
+    VariantScheduler m_play_scheduler;
+    VariantIntegrator m_integrator;
+    CommandBuffer m_commands{m_storage};
+
+    std::vector<std::pair<entity_id, variant_type_index>> m_dead_variants;
+    std::vector<entity_id> m_dead_entities;
 
     // NOTE: maybe move these to somewhere else
     RenderTexture2D m_render_texture;
@@ -3,4 +3,20 @@
 #include <cstdint>
 #include <string>
 
+// Runtime entity handle: the low 32 bits index the entity's slot, the high 32 bits
+// hold the slot's generation. Destroying an entity bumps its slot's generation, so
+// handles kept past that point no longer match and read as stale.
 using entity_id = uint64_t;
+
+// Persistent identity of an entity, only used where it outlives a run: scene
+// files and the editor protocol.
+using entity_guid = uint64_t;
+
+constexpr entity_id INVALID_ENTITY = UINT64_MAX;
+
+inline constexpr uint32_t get_entity_index(entity_id id) { return static_cast<uint32_t>(id); }
+inline constexpr uint32_t get_entity_generation(entity_id id) { return static_cast<uint32_t>(id >> 32); }
+
+inline constexpr entity_id make_entity_id(uint32_t index, uint32_t generation) {
+    return (static_cast<entity_id>(generation) << 32) | index;
+}
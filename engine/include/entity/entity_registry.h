@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+
+#include "entity/entity.h"
+
+// Hands out entity handles. Destroyed slots go to a free list and are reused
+// with a bumped generation, so indices stay dense for array-indexed storage and
+// create, destroy and is_alive are all O(1).
+// GUIDs are only assigned when something asks for one (serialization, editor).
+// Everything but reserve is main thread only.
+class EntityRegistry {
+public:
+    entity_id create();
+    entity_id create(entity_guid guid);
+    // Thread-safe: takes a never used index without touching the slots, so jobs
+    // can take handles while other jobs read the slots. The handle is not alive
+    // until commit is called on it.
+    entity_id reserve();
+    // Returns false when the registry was cleared since the handle was reserved.
+    bool commit(entity_id id);
+    void destroy(entity_id id);
+    void clear();
+
+    inline bool is_alive(entity_id id) const {
+        const uint32_t index = get_entity_index(id);
+        return index < m_slots.size() && m_slots[index].alive && m_slots[index].generation == get_entity_generation(id);
+    }
+
+    entity_guid get_guid(entity_id id);
+    // Returns INVALID_ENTITY when no live entity has the guid.
+    entity_id find(entity_guid guid) const;
+
+    // fn(entity_id) for every live entity, in slot order.
+    template<typename F>
+    void each(F&& fn) const {
+        for (uint32_t index = 0; index < m_slots.size(); index++) {
+            if (m_slots[index].alive) {
+                fn(make_entity_id(index, m_slots[index].generation));
+            }
+        }
+    }
+
+    inline size_t get_slot_count() const { return m_slots.size(); }
+
+private:
+    struct Slot {
+        uint32_t generation = 0;
+        bool alive = false;
+        bool has_guid = false;
+        entity_guid guid = 0;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_free;
+    // first index neither create nor reserve has handed out yet
+    std::atomic<uint32_t> m_next_index{ 0 };
+    // reservations below this were made before the last clear
+    uint32_t m_first_reservation = 0;
+    std::unordered_map<entity_guid, entity_id> m_guids;
+};
@@ -17,10 +17,13 @@ public:
     void on_play_update() override;
     
     void launch();
+    void stop();
     void reset_position(float x, float y);
     void handle_collision(Collider& other);
     
 private:
+    // pushes the ball out of other and reflects its velocity
+    void bounce(Collider& other);
     void handle_collisions();
     void handle_paddle_collision();
     void handle_brick_collision();
@@ -9,13 +9,17 @@ class Brick : public VariantBase {
 public:
     Brick(int health, Color color) : m_health(health), m_inital_health(health), m_color(color) {}
 
-    void on_play_update() override;
+    void on_update() override;
     void damage();
     void reset();
     inline bool is_destroyed() { return m_health <= 0; }
 
     int get_initial_health() const { return m_inital_health; }
 
+    // for bricks spawned in place, see BrickManager::create_bricks
+    inline void set_health(int health) { m_health = m_inital_health = health; }
+    inline void set_color(Color color) { m_color = color; }
+
 private:
     int m_health = 0;
     int m_inital_health = 0; // used for resetting
@@ -7,6 +7,7 @@
 
 class BrickManager : public VariantBase {
     VARIANT(BrickManager);
+    SINGLETON()
 
 public:
     int rows = 5; PROPERTY()
@@ -25,6 +26,5 @@ public:
     void create_bricks();
     
 private:
-    void create_brick(float x, float y, int row, int col);
     Color get_brick_color(int row) const;
 };
@@ -5,6 +5,7 @@
 
 class Camera2DSystem : public VariantBase {
     VARIANT(Camera2DSystem);
+    SINGLETON()
 
 public:
     float zoom = 1.0f; PROPERTY()
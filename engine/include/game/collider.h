@@ -1,12 +1,25 @@
 #pragma once
 
 #include "variant/variant_base.h"
+#include "core/physics/aabb.h"
 #include "game/position.h"
 
+enum class ColliderType : int {
+    None = 0,
+    Rectangle = 1,
+    Circle = 2,
+};
+
+// Shape of an entity for collision. CollisionSystem finds the touching pairs
+// each play step and reports each contact to both sides: enter on the first
+// step they touch, stay on every step after that, exit on the first step they
+// no longer do.
 class Collider : public VariantBase {
     VARIANT(Collider)
 
 public:
+    using collision_callback = std::function<void(Collider& other)>;
+
     int m_collider_type = 0; PROPERTY() // 0=None, 1=Rectangle, 2=Circle
     bool m_is_trigger = false; PROPERTY()  
     
@@ -14,25 +27,34 @@ public:
     float m_height = 0.0f; PROPERTY()
     float m_radius = 0.0f; PROPERTY()
 
-    bool m_static = false; PROPERTY()
+    bool m_static = false; PROPERTY() // level geometry: never tested against other static colliders
+    // circles only: swept along their Velocity in steps where they move farther
+    // than their radius, so they cannot pass through thin colliders
+    bool m_ccd = false; PROPERTY()
     bool m_draw_debug = false; PROPERTY()
     
     void on_update() override;
-    void on_play_update() override;
     bool intersects(const Collider& other) const;
+    // Same test with the positions already at hand, as CollisionSystem has them.
+    bool intersects(const Collider& other, const Position& position, const Position& other_position) const;
 
     Rectangle get_rectangle() const;
+    Rectangle get_rectangle(const Position& position) const;
     Vector2 get_circle_center() const;
+    Vector2 get_circle_center(const Position& position) const;
+    Aabb get_bounds(const Position& position) const;
     inline float get_radius() const { return m_radius; }
 
-    std::function<void(Collider& other)> m_callback;
+    collision_callback m_on_collision_enter;
+    collision_callback m_on_collision_stay;
+    // gets only the other entity's id, its collider may be gone by then
+    std::function<void(uint64_t other)> m_on_collision_exit;
 
     inline void set_enable(bool value) { m_enable = value; }
     inline bool is_enable() { return m_enable; }
 
 private:
     void debug_draw();
-    void check_collisions();
 
     bool m_enable = true;
 };
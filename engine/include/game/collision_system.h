@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include "variant/variant_base.h"
+#include "core/physics/broad_phase.h"
+#include "core/physics/contact_cache.h"
+#include "core/physics/sweep.h"
+#include "game/collider.h"
+#include "game/position.h"
+
+// Finds the touching colliders once per play step and reports the contacts to
+// them. A broadphase over the colliders' bounds picks the candidate pairs, so
+// only colliders that are close reach Collider::intersects. The touching pairs
+// are diffed against the previous step's and handed out in batches: every enter
+// first, then every stay, then every exit. Circles with m_ccd set that would
+// move farther than their radius this step are swept along their velocity and
+// stopped at their first impact, so they cannot pass through thin colliders.
+// After the callbacks ran, whatever is left of the step is swept again at the
+// new velocity, up to four impacts a step; later impacts get their enter
+// callbacks right away.
+// Add one to the scene for collisions to happen.
+class CollisionSystem : public VariantBase {
+    VARIANT(CollisionSystem);
+    SINGLETON()
+    MAIN_THREAD() // fires collision callbacks into other variants
+
+public:
+    int broadphase = 0; PROPERTY() // 0=AabbTree, 1=Grid
+    // AabbTree: how far a collider may move before its tree leaf is refitted
+    float tree_margin = 8.0f; PROPERTY()
+    // Grid: a bit larger than the common collider keeps most of them in one to four cells
+    float cell_size = 128.0f; PROPERTY()
+
+    void on_play_update() override;
+
+private:
+    void gather_colliders();
+    Vector2 get_motion(const Collider& collider) const;
+    void resolve_impacts();
+    float time_of_impact(uint32_t mover, uint32_t target, Vector2 motion) const;
+    void find_contacts();
+    void dispatch_contacts();
+    void finish_impacts();
+    // Sweeps what is left of the step and stops at the next impact, if any.
+    bool sweep_remaining(Impact& impact);
+
+    void notify(const Contact& contact, Collider::collision_callback Collider::* callback);
+    void notify_exit(uint64_t id, uint64_t other);
+
+    BroadPhase m_broad_phase;
+    ContactCache m_contacts;
+
+    // indexed by body number
+    std::vector<Collider*> m_colliders;
+    std::vector<Position*> m_positions;
+    // how far each body moves this step, zero unless it is swept
+    std::vector<Vector2> m_motions;
+    std::vector<float> m_times;
+    std::vector<ProxyPair> m_pairs;
+
+    std::vector<uint32_t> m_swept;
+    std::vector<Impact> m_impacts;
+    std::vector<uint32_t> m_candidates;
+};
@@ -18,6 +18,8 @@ enum class GameState {
 
 class Game : public VariantBase {
     VARIANT(Game);
+    SINGLETON()
+    MAIN_THREAD() // fires game state callbacks into other variants
 
 public:
     GameState get_game_state() const { return m_game_state; }
@@ -3,6 +3,7 @@
 #include "game/brick_manager.h"
 #include "game/camera2d.h"
 #include "game/collider.h"
+#include "game/collision_system.h"
 #include "game/cube.h"
 #include "game/game.h"
 #include "game/paddle.h"
@@ -73,39 +74,25 @@ RTTR_REGISTRATION
         .property("format", &Texture2D::format)
         (rttr::metadata("NO_VARIANT", true));
 
-    rttr::registration::class_<Sprite>("Sprite")
-        .constructor<>()(rttr::policy::ctor::as_object)
-        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("path_to_sprite", &Sprite::path_to_sprite)(rttr::metadata("SET_CALLBACK", "handle_new_path"))
-
-        .method("handle_new_path", &Sprite::handle_new_path);
-
-    rttr::registration::class_<Paddle>("Paddle")
-        .constructor<>()(rttr::policy::ctor::as_object)
-        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("width", &Paddle::width)
-        .property("height", &Paddle::height)
-        .property("speed", &Paddle::speed);
-
-    rttr::registration::class_<Speed>("Speed")
-        .constructor<>()(rttr::policy::ctor::as_object)
-        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("value", &Speed::value);
-
-    rttr::registration::class_<Scale>("Scale")
+    rttr::registration::class_<Ball>("Ball")
         .constructor<>()(rttr::policy::ctor::as_object)
-        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("x", &Scale::x)
-        .property("y", &Scale::y);
+        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object);
 
-    rttr::registration::class_<Game>("Game")
+    rttr::registration::class_<Brick>("Brick")
         .constructor<>()(rttr::policy::ctor::as_object)
         .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object);
 
-    rttr::registration::class_<Tag>("Tag")
+    rttr::registration::class_<BrickManager>("BrickManager")
         .constructor<>()(rttr::policy::ctor::as_object)
         .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("value", &Tag::value);
+        .property("rows", &BrickManager::rows)
+        .property("columns", &BrickManager::columns)
+        .property("brick_width", &BrickManager::brick_width)
+        .property("brick_height", &BrickManager::brick_height)
+        .property("padding_x", &BrickManager::padding_x)
+        .property("padding_y", &BrickManager::padding_y)
+        .property("start_x", &BrickManager::start_x)
+        .property("start_y", &BrickManager::start_y);
 
     rttr::registration::class_<Camera2DSystem>("Camera2DSystem")
         .constructor<>()(rttr::policy::ctor::as_object)
@@ -119,14 +106,24 @@ RTTR_REGISTRATION
         .property("drag_speed", &Camera2DSystem::drag_speed)
         .property("m_target", &Camera2DSystem::m_target);
 
-    rttr::registration::class_<Score>("Score")
+    rttr::registration::class_<Collider>("Collider")
         .constructor<>()(rttr::policy::ctor::as_object)
         .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("value", &Score::value)
-        .property("point_base", &Score::point_base)
-        .property("font_size", &Score::font_size)
-        .property("x", &Score::x)
-        .property("y", &Score::y);
+        .property("m_collider_type", &Collider::m_collider_type)
+        .property("m_is_trigger", &Collider::m_is_trigger)
+        .property("m_width", &Collider::m_width)
+        .property("m_height", &Collider::m_height)
+        .property("m_radius", &Collider::m_radius)
+        .property("m_static", &Collider::m_static)
+        .property("m_ccd", &Collider::m_ccd)
+        .property("m_draw_debug", &Collider::m_draw_debug);
+
+    rttr::registration::class_<CollisionSystem>("CollisionSystem")
+        .constructor<>()(rttr::policy::ctor::as_object)
+        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
+        .property("broadphase", &CollisionSystem::broadphase)
+        .property("tree_margin", &CollisionSystem::tree_margin)
+        .property("cell_size", &CollisionSystem::cell_size);
 
     rttr::registration::class_<Cube>("Cube")
         .constructor<>()(rttr::policy::ctor::as_object)
@@ -135,47 +132,59 @@ RTTR_REGISTRATION
         .property("height", &Cube::height)
         .property("color", &Cube::color);
 
-    rttr::registration::class_<Ball>("Ball")
+    rttr::registration::class_<Game>("Game")
         .constructor<>()(rttr::policy::ctor::as_object)
         .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object);
 
-    rttr::registration::class_<Brick>("Brick")
+    rttr::registration::class_<Paddle>("Paddle")
         .constructor<>()(rttr::policy::ctor::as_object)
-        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object);
+        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
+        .property("width", &Paddle::width)
+        .property("height", &Paddle::height)
+        .property("speed", &Paddle::speed);
 
-    rttr::registration::class_<Velocity>("Velocity")
+    rttr::registration::class_<Position>("Position")
         .constructor<>()(rttr::policy::ctor::as_object)
         .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("x", &Velocity::x)
-        .property("y", &Velocity::y);
+        .property("x", &Position::x)
+        .property("y", &Position::y);
 
-    rttr::registration::class_<BrickManager>("BrickManager")
+    rttr::registration::class_<Scale>("Scale")
         .constructor<>()(rttr::policy::ctor::as_object)
         .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("rows", &BrickManager::rows)
-        .property("columns", &BrickManager::columns)
-        .property("brick_width", &BrickManager::brick_width)
-        .property("brick_height", &BrickManager::brick_height)
-        .property("padding_x", &BrickManager::padding_x)
-        .property("padding_y", &BrickManager::padding_y)
-        .property("start_x", &BrickManager::start_x)
-        .property("start_y", &BrickManager::start_y);
+        .property("x", &Scale::x)
+        .property("y", &Scale::y);
 
-    rttr::registration::class_<Position>("Position")
+    rttr::registration::class_<Score>("Score")
         .constructor<>()(rttr::policy::ctor::as_object)
         .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("x", &Position::x)
-        .property("y", &Position::y);
+        .property("value", &Score::value)
+        .property("point_base", &Score::point_base)
+        .property("font_size", &Score::font_size)
+        .property("x", &Score::x)
+        .property("y", &Score::y);
 
-    rttr::registration::class_<Collider>("Collider")
+    rttr::registration::class_<Speed>("Speed")
         .constructor<>()(rttr::policy::ctor::as_object)
         .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
-        .property("m_collider_type", &Collider::m_collider_type)
-        .property("m_is_trigger", &Collider::m_is_trigger)
-        .property("m_width", &Collider::m_width)
-        .property("m_height", &Collider::m_height)
-        .property("m_radius", &Collider::m_radius)
-        .property("m_static", &Collider::m_static)
-        .property("m_draw_debug", &Collider::m_draw_debug);
+        .property("value", &Speed::value);
+
+    rttr::registration::class_<Sprite>("Sprite")
+        .constructor<>()(rttr::policy::ctor::as_object)
+        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
+        .property("path_to_sprite", &Sprite::path_to_sprite)(rttr::metadata("SET_CALLBACK", "handle_new_path"))
+
+        .method("handle_new_path", &Sprite::handle_new_path);
+
+    rttr::registration::class_<Tag>("Tag")
+        .constructor<>()(rttr::policy::ctor::as_object)
+        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
+        .property("value", &Tag::value);
+
+    rttr::registration::class_<Velocity>("Velocity")
+        .constructor<>()(rttr::policy::ctor::as_object)
+        .constructor<VariantCreateInfo>()(rttr::policy::ctor::as_object)
+        .property("x", &Velocity::x)
+        .property("y", &Velocity::y);
 
 }
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "variant/variant_access.h"
+
+constexpr VariantAccess VARIANT_ACCESS[VARIANT_TYPE_COUNT] = {
+    { 0x0000000000000000ull, 0x0000000000008211ull, true }, // Ball
+    { 0x0000000000000000ull, 0x0000000000000002ull, false }, // Brick
+    { 0x0000000000000000ull, 0x0000000000000004ull, false }, // BrickManager
+    { 0x0000000000000000ull, 0x0000000000000008ull, false }, // Camera2DSystem
+    { 0x0000000000000000ull, 0x0000000000000010ull, false }, // Collider
+    { 0x0000000000000000ull, 0x0000000000000020ull, true }, // CollisionSystem
+    { 0x0000000000001000ull, 0x0000000000000240ull, false }, // Cube
+    { 0x0000000000000000ull, 0x0000000000000080ull, true }, // Game
+    { 0x0000000000000000ull, 0x0000000000000300ull, false }, // Paddle
+    { 0x0000000000000000ull, 0x0000000000000200ull, false }, // Position
+    { 0x0000000000000000ull, 0x0000000000000400ull, false }, // Scale
+    { 0x0000000000000000ull, 0x0000000000000800ull, false }, // Score
+    { 0x0000000000000000ull, 0x0000000000001000ull, false }, // Speed
+    { 0x0000000000000000ull, 0x0000000000002000ull, false }, // Sprite
+    { 0x0000000000000000ull, 0x0000000000004000ull, false }, // Tag
+    { 0x0000000000000000ull, 0x0000000000008000ull, false }, // Velocity
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "game/ball.h"
+#include "game/brick.h"
+#include "game/brick_manager.h"
+#include "game/camera2d.h"
+#include "game/collider.h"
+#include "game/collision_system.h"
+#include "game/cube.h"
+#include "game/game.h"
+#include "game/paddle.h"
+#include "game/position.h"
+#include "game/scale.h"
+#include "game/score.h"
+#include "game/speed.h"
+#include "game/sprite.h"
+#include "game/tag.h"
+#include "game/velocity.h"
+#include "core/storage/variant_arena.h"
+
+const VariantTypeOps VARIANT_TYPE_OPS[VARIANT_TYPE_COUNT] = {
+    make_variant_type_ops<Ball>(),
+    make_variant_type_ops<Brick>(),
+    make_variant_type_ops<BrickManager>(),
+    make_variant_type_ops<Camera2DSystem>(),
+    make_variant_type_ops<Collider>(),
+    make_variant_type_ops<CollisionSystem>(),
+    make_variant_type_ops<Cube>(),
+    make_variant_type_ops<Game>(),
+    make_variant_type_ops<Paddle>(),
+    make_variant_type_ops<Position>(&Position::x, &Position::y),
+    make_variant_type_ops<Scale>(&Scale::x, &Scale::y),
+    make_variant_type_ops<Score>(),
+    make_variant_type_ops<Speed>(),
+    make_variant_type_ops<Sprite>(),
+    make_variant_type_ops<Tag>(),
+    make_variant_type_ops<Velocity>(&Velocity::x, &Velocity::y),
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "variant/variant_type.h"
+
+class Ball;
+class Brick;
+class BrickManager;
+class Camera2DSystem;
+class Collider;
+class CollisionSystem;
+class Cube;
+class Game;
+class Paddle;
+class Position;
+class Scale;
+class Score;
+class Speed;
+class Sprite;
+class Tag;
+class Velocity;
+
+template<> struct VariantTypeIndex<Ball> { static constexpr variant_type_index value = 0; };
+template<> struct VariantTypeIndex<Brick> { static constexpr variant_type_index value = 1; };
+template<> struct VariantTypeIndex<BrickManager> { static constexpr variant_type_index value = 2; };
+template<> struct VariantTypeIndex<Camera2DSystem> { static constexpr variant_type_index value = 3; };
+template<> struct VariantTypeIndex<Collider> { static constexpr variant_type_index value = 4; };
+template<> struct VariantTypeIndex<CollisionSystem> { static constexpr variant_type_index value = 5; };
+template<> struct VariantTypeIndex<Cube> { static constexpr variant_type_index value = 6; };
+template<> struct VariantTypeIndex<Game> { static constexpr variant_type_index value = 7; };
+template<> struct VariantTypeIndex<Paddle> { static constexpr variant_type_index value = 8; };
+template<> struct VariantTypeIndex<Position> { static constexpr variant_type_index value = 9; };
+template<> struct VariantTypeIndex<Scale> { static constexpr variant_type_index value = 10; };
+template<> struct VariantTypeIndex<Score> { static constexpr variant_type_index value = 11; };
+template<> struct VariantTypeIndex<Speed> { static constexpr variant_type_index value = 12; };
+template<> struct VariantTypeIndex<Sprite> { static constexpr variant_type_index value = 13; };
+template<> struct VariantTypeIndex<Tag> { static constexpr variant_type_index value = 14; };
+template<> struct VariantTypeIndex<Velocity> { static constexpr variant_type_index value = 15; };
+
+constexpr variant_type_index VARIANT_TYPE_COUNT = 16;
+
+constexpr const char* VARIANT_TYPE_NAMES[VARIANT_TYPE_COUNT] = {
+    "Ball",
+    "Brick",
+    "BrickManager",
+    "Camera2DSystem",
+    "Collider",
+    "CollisionSystem",
+    "Cube",
+    "Game",
+    "Paddle",
+    "Position",
+    "Scale",
+    "Score",
+    "Speed",
+    "Sprite",
+    "Tag",
+    "Velocity",
+};
+
+constexpr variant_mask VARIANT_SINGLETONS = 0x00000000000009acull;
+
+constexpr variant_hook_mask VARIANT_HOOKS[VARIANT_TYPE_COUNT] = {
+    VARIANT_HOOK_UPDATE | VARIANT_HOOK_PLAY_START | VARIANT_HOOK_PLAY_UPDATE, // Ball
+    VARIANT_HOOK_UPDATE, // Brick
+    VARIANT_HOOK_PLAY_START, // BrickManager
+    VARIANT_HOOK_UPDATE, // Camera2DSystem
+    VARIANT_HOOK_UPDATE, // Collider
+    VARIANT_HOOK_PLAY_UPDATE, // CollisionSystem
+    VARIANT_HOOK_UPDATE | VARIANT_HOOK_PLAY_UPDATE, // Cube
+    VARIANT_HOOK_PLAY_UPDATE, // Game
+    VARIANT_HOOK_UPDATE | VARIANT_HOOK_PLAY_UPDATE, // Paddle
+    0, // Position
+    0, // Scale
+    VARIANT_HOOK_UPDATE | VARIANT_HOOK_PLAY_START, // Score
+    0, // Speed
+    VARIANT_HOOK_UPDATE, // Sprite
+    0, // Tag
+    0, // Velocity
+};
+
+constexpr std::array<VariantIntegration, 1> VARIANT_INTEGRATIONS = {{
+    { 15, 9 }, // Velocity into Position
+}};
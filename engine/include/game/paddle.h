@@ -7,6 +7,7 @@
 
 class Paddle : public VariantBase {
     VARIANT(Paddle);
+    SINGLETON()
 
 public:
     float width = 100.0f; PROPERTY()
@@ -4,6 +4,7 @@
 
 class Position : public VariantBase {
     VARIANT(Position)
+    SOA()
 
 public:
     Position(float x, float y) : x(x), y(y) {}
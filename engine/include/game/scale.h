@@ -4,6 +4,7 @@
 
 class Scale : public VariantBase {
     VARIANT(Scale);
+    SOA()
 
 public:
     Scale(int x, int y) : x(x), y(y) {}
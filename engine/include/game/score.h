@@ -5,6 +5,7 @@
 
 class Score : public VariantBase {
     VARIANT(Score);
+    SINGLETON()
 
 public:
     float value = 0; PROPERTY();
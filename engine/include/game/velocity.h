@@ -6,6 +6,8 @@
 
 class Velocity : public VariantBase {
     VARIANT(Velocity);
+    SOA()
+    INTEGRATE_INTO(Position) // position += velocity * fixed step delta, done by the engine after each play step
 
 public:
     float x = 0.0f; PROPERTY()
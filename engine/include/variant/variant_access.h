@@ -0,0 +1,22 @@
+#pragma once
+
+#include "variant/variant_type.h"
+
+// What a variant type's on_play_update touches, as extracted by scripts/parser2.py.
+// Bits are VariantTypeIndex values. Exclusive types reach outside their own
+// entity (other entities, the world, the renderer) and always run alone on the main thread.
+struct VariantAccess {
+    variant_mask reads;
+    variant_mask writes;
+    bool exclusive;
+};
+
+inline bool access_conflicts(const VariantAccess& a, const VariantAccess& b) {
+    if (a.exclusive || b.exclusive) {
+        return true;
+    }
+
+    return (a.writes & (b.reads | b.writes)) != 0 || (b.writes & a.reads) != 0;
+}
+
+#include "game/generated/variant_access.h"
@@ -3,6 +3,10 @@
 
 #define PROPERTY() 
 #define IGNORE_QUERIES()
+#define MAIN_THREAD()
+#define SINGLETON()
+#define SOA()
+#define INTEGRATE_INTO(...)
 #define REQUIRES(...)
 
 #define SET_CALLBACK(callback_name) \
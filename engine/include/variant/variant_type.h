@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "rttr/type.h"
+
+using variant_type_index = uint32_t;
+using variant_mask = uint64_t;
+
+constexpr variant_type_index INVALID_VARIANT_TYPE = UINT32_MAX;
+constexpr variant_type_index MAX_VARIANT_TYPES = 64;
+
+template<typename T>
+struct dependent_false : std::false_type {};
+
+// Dense, compile-time index of every VARIANT(ClassName). Specializations are
+// generated by scripts/parser2.py into game/generated/variant_types.h.
+template<typename T>
+struct VariantTypeIndex {
+    static_assert(dependent_false<T>::value, "Missing variant type index, run scripts/parser2.py");
+};
+
+// Lifecycle hooks a variant type overrides, detected by scripts/parser2.py.
+// The lifecycle passes only visit the pools of types that override the hook.
+using variant_hook_mask = uint32_t;
+
+enum VariantHook : variant_hook_mask {
+    VARIANT_HOOK_POST_INIT = 1 << 0,
+    VARIANT_HOOK_UPDATE = 1 << 1,
+    VARIANT_HOOK_PLAY_START = 1 << 2,
+    VARIANT_HOOK_PLAY_LATE_START = 1 << 3,
+    VARIANT_HOOK_PLAY_UPDATE = 1 << 4,
+};
+
+// INTEGRATE_INTO(Target) in an SOA() variant: after every fixed play step the
+// engine adds its fields, times the fixed step delta, to the fields of the
+// entity's Target.
+struct VariantIntegration {
+    variant_type_index source;
+    variant_type_index target;
+};
+
+// Maps an rttr type back to its index, for paths that only know the type at
+// runtime (editor, deserialization). Returns INVALID_VARIANT_TYPE for non-variants.
+variant_type_index get_variant_type_index(const rttr::type& type);
+
+rttr::type get_variant_rttr_type(variant_type_index index);
+
+// Lifecycle passes run type by type in the dispatch order: by default type index
+// order, which is stable across runs. Types listed in `first` are moved to the front,
+// in the given order; the rest keep index order.
+void set_variant_dispatch_order(const std::vector<variant_type_index>& first);
+const std::vector<variant_type_index>& get_variant_dispatch_order();
+
+// Type indices overriding the hook, in dispatch order.
+const std::vector<variant_type_index>& get_hooked_variant_types(VariantHook hook);
+
+#include "game/generated/variant_types.h"
+
+static_assert(VARIANT_TYPE_COUNT <= MAX_VARIANT_TYPES, "variant_mask holds at most 64 variant types");
+
+// Types marked SINGLETON() have at most one instance; the storage keeps a direct
+// pointer to it and rejects a second one.
+inline bool is_singleton_variant(variant_type_index index) {
+    return index < VARIANT_TYPE_COUNT && ((VARIANT_SINGLETONS >> index) & 1) != 0;
+}
+
+// Bit set of the given variant types, as tested against an entity's mask.
+template<typename... Ts>
+constexpr variant_mask variant_mask_of = ((variant_mask(1) << VariantTypeIndex<Ts>::value) | ... | variant_mask(0));
+
+template<typename T>
+constexpr bool is_singleton_variant_v = ((VARIANT_SINGLETONS >> VariantTypeIndex<T>::value) & 1) != 0;
@@ -8,12 +8,19 @@ import sys
 from pathlib import Path
 from typing import Dict, List, Tuple, Optional, Set, Any, Union
 
+# lifecycle hooks the engine dispatches per type, in VariantHook bit order
+VARIANT_HOOKS = ['on_post_init', 'on_update', 'on_play_start', 'on_play_late_start', 'on_play_update']
+
 class ClassParser:
     def __init__(self):
         self.variant_pattern = re.compile(r'VARIANT\((\w+)\)')
         self.class_pattern = re.compile(r'(struct|class)\s+(\w+)\s*(?::\s*public\s+(\w+))?')
         self.requires_pattern = re.compile(r'REQUIRES\s*\(\s*(.*?)\s*\)')
         self.ignore_queries_pattern = re.compile(r'IGNORE_QUERIES\s*\(\s*\)')
+        self.main_thread_pattern = re.compile(r'MAIN_THREAD\s*\(\s*\)')
+        self.singleton_pattern = re.compile(r'\bSINGLETON\s*\(\s*\)')
+        self.soa_pattern = re.compile(r'\bSOA\s*\(\s*\)')
+        self.integrate_into_pattern = re.compile(r'\bINTEGRATE_INTO\s*\(\s*(\w+)\s*\)')
 
         self.property_pattern = re.compile(r'(\w+(?:::\w+)*(?:\s*\*)?)\s+(\w+)(?:\s*=\s*[^;]*)?;\s*PROPERTY\(\)(?:\s+SET_CALLBACK\((\w+)\))?')
         
@@ -22,6 +29,9 @@ class ClassParser:
         self.query_get_pattern = re.compile(r'Query::get<([\w,\s]+)>\(this\)')
         self.query_read_pattern = re.compile(r'Query::read<([\w,\s]+)>\(this\)')
         self.query_try_get_pattern = re.compile(r'Query::try_get<([\w,\s]+)>\(this\)')
+
+        self.query_call_pattern = re.compile(r'Query::(\w+)\s*(?:<([\w,\s]*)>)?\s*\(([^)]*)\)')
+        self.main_thread_call_pattern = re.compile(r'\b(?:draw_\w+|Draw\w+|begin_\w+|end_\w+|Zeytin::)')
         
         self.skip_classes = ["VariantCreateInfo", "VariantBase"]
 
@@ -63,7 +73,7 @@ class ClassParser:
             return class_block[:close_pos]
         return class_block
 
-    def parse_variant_class(self, class_block: str, class_name: str, base_class: str) -> Optional[Dict[str, Any]]:
+    def parse_variant_class(self, class_block: str, class_name: str, base_class: str, class_type: str = "class") -> Optional[Dict[str, Any]]:
         if class_name in self.skip_classes:
             return None
         
@@ -71,6 +81,22 @@ class ClassParser:
         ignore_queries_match = self.ignore_queries_pattern.search(class_block)
         if ignore_queries_match:
             ignore_queries = True
+
+        main_thread = self.main_thread_pattern.search(class_block) is not None
+        singleton = self.singleton_pattern.search(class_block) is not None
+        soa = self.soa_pattern.search(class_block) is not None
+        integrate_into_match = self.integrate_into_pattern.search(class_block)
+        integrate_into = integrate_into_match.group(1) if integrate_into_match else None
+
+        # overrides inherited from another variant aren't visible here, so such types get every hook
+        if base_class == 'VariantBase':
+            hooks = [hook for hook in VARIANT_HOOKS if re.search(r'\b' + hook + r'\s*\(\s*\)[^;{]*\boverride\b', class_block)]
+        else:
+            hooks = list(VARIANT_HOOKS)
+
+        # replaced by the cpp analysis when one is found; an inline on_play_update can't be analyzed
+        inline_play_update = re.search(r'on_play_update\s*\([^)]*\)[^;{]*\{', class_block) is not None
+        access = {'reads': set(), 'writes': {class_name}, 'exclusive': inline_play_update}
         
         required_variants = []
         requires_matches = list(self.requires_pattern.finditer(class_block))
@@ -95,11 +121,18 @@ class ClassParser:
         
         return {
             'class_name': class_name,
+            'class_type': class_type,
             'base_class': base_class,
             'properties': properties,
             'required_variants': required_variants,
             'is_variant': True,
-            'ignore_queries': ignore_queries
+            'ignore_queries': ignore_queries,
+            'main_thread': main_thread,
+            'singleton': singleton,
+            'soa': soa,
+            'integrate_into': integrate_into,
+            'hooks': hooks,
+            'access': access
         }
 
     def parse_regular_class(self, class_block: str, class_name: str, base_class: str) -> Optional[Dict[str, Any]]:
@@ -171,7 +204,7 @@ class ClassParser:
             is_variant = class_name in variant_classes
             
             if is_variant:
-                variant_info = self.parse_variant_class(class_block, class_name, base_class)
+                variant_info = self.parse_variant_class(class_block, class_name, base_class, class_type)
                 if variant_info:
                     results.append(variant_info)
             else:
@@ -231,6 +264,69 @@ class ClassParser:
         
         return dependencies
 
+    def extract_method_bodies(self, cpp_content: str, class_name: str) -> Dict[str, str]:
+        method_pattern = re.compile(r'\b' + re.escape(class_name) + r'::(\w+)\s*\([^)]*\)\s*(?:const\s*)?\{')
+        bodies = {}
+
+        for match in method_pattern.finditer(cpp_content):
+            start = match.end() - 1
+            open_braces = 0
+
+            for i in range(start, len(cpp_content)):
+                if cpp_content[i] == '{':
+                    open_braces += 1
+                elif cpp_content[i] == '}':
+                    open_braces -= 1
+                    if open_braces == 0:
+                        bodies[match.group(1)] = cpp_content[start:i + 1]
+                        break
+
+        return bodies
+
+    def extract_play_update_access(self, cpp_content: str, class_name: str) -> Dict[str, Any]:
+        """Read/write sets of on_play_update and the class methods it calls.
+        get/try_get on this are exclusive (write) access, read/has on this are shared (read)
+        access. Anything touching other entities, the world or the renderer is exclusive."""
+        access = {'reads': set(), 'writes': {class_name}, 'exclusive': False}
+
+        bodies = self.extract_method_bodies(self.clean_content(cpp_content), class_name)
+        if 'on_play_update' not in bodies:
+            return access
+
+        reachable = ['on_play_update']
+        visited = set()
+        while reachable:
+            method = reachable.pop()
+            if method in visited:
+                continue
+            visited.add(method)
+
+            for other in bodies:
+                if other not in visited and re.search(r'\b' + re.escape(other) + r'\s*\(', bodies[method]):
+                    reachable.append(other)
+
+        for method in visited:
+            body = bodies[method]
+
+            if self.main_thread_call_pattern.search(body):
+                access['exclusive'] = True
+
+            for match in self.query_call_pattern.finditer(body):
+                function = match.group(1)
+                variants = [param.strip() for param in (match.group(2) or '').split(',') if param.strip()]
+                on_this = match.group(3).strip() == 'this'
+
+                if function == 'delta_time':
+                    continue  # constant for the whole step
+                elif on_this and function in ('get', 'try_get'):
+                    access['writes'].update(variants)
+                elif on_this and function in ('read', 'has'):
+                    access['reads'].update(variants)
+                else:
+                    access['exclusive'] = True
+
+        return access
+
 
 class CodeGenerator:
     @staticmethod
@@ -348,6 +444,126 @@ class CodeGenerator:
         registration_code += "}\n"
         return registration_code
 
+    @staticmethod
+    def sorted_variants(classes_info: List[Dict[str, Any]]) -> List[Dict[str, Any]]:
+        return sorted((c for c in classes_info if c['is_variant']), key=lambda c: c['class_name'])
+
+    MAX_SOA_FIELDS = 4
+
+    @staticmethod
+    def soa_fields(class_info: Dict[str, Any]) -> List[str]:
+        return [name for _, name, _ in class_info['properties']] if class_info.get('soa') else []
+
+    @staticmethod
+    def validate_soa(classes_info: List[Dict[str, Any]]) -> None:
+        variants = {c['class_name']: c for c in classes_info if c['is_variant']}
+
+        for class_info in variants.values():
+            if not class_info.get('soa'):
+                continue
+
+            types = [prop_type for prop_type, _, _ in class_info['properties']]
+            if not types or any(t != 'float' for t in types) or len(types) > CodeGenerator.MAX_SOA_FIELDS:
+                print(f"Warning: {class_info['class_name']} is SOA() but needs 1 to {CodeGenerator.MAX_SOA_FIELDS} float properties and nothing else, ignoring SOA()")
+                class_info['soa'] = False
+
+        for class_info in variants.values():
+            target_name = class_info.get('integrate_into')
+            if not target_name:
+                continue
+
+            target = variants.get(target_name)
+            if not class_info['soa'] or not target or not target.get('soa') or \
+                    len(CodeGenerator.soa_fields(class_info)) != len(CodeGenerator.soa_fields(target)):
+                print(f"Warning: {class_info['class_name']} INTEGRATE_INTO({target_name}) needs two SOA() variants with the same number of fields, ignoring it")
+                class_info['integrate_into'] = None
+
+    @staticmethod
+    def generate_variant_types_header(classes_info: List[Dict[str, Any]]) -> str:
+        variants = CodeGenerator.sorted_variants(classes_info)
+
+        code = "#pragma once\n\n"
+        code += '#include "variant/variant_type.h"\n\n'
+
+        for class_info in variants:
+            code += f"{class_info['class_type']} {class_info['class_name']};\n"
+        code += "\n"
+
+        for index, class_info in enumerate(variants):
+            code += f"template<> struct VariantTypeIndex<{class_info['class_name']}> {{ static constexpr variant_type_index value = {index}; }};\n"
+        code += "\n"
+
+        code += f"constexpr variant_type_index VARIANT_TYPE_COUNT = {len(variants)};\n\n"
+
+        code += "constexpr const char* VARIANT_TYPE_NAMES[VARIANT_TYPE_COUNT] = {\n"
+        for class_info in variants:
+            code += f'    "{class_info["class_name"]}",\n'
+        code += "};\n\n"
+
+        singletons = 0
+        for index, class_info in enumerate(variants):
+            if class_info['singleton']:
+                singletons |= 1 << index
+        code += f"constexpr variant_mask VARIANT_SINGLETONS = 0x{singletons:016x}ull;\n\n"
+
+        code += "constexpr variant_hook_mask VARIANT_HOOKS[VARIANT_TYPE_COUNT] = {\n"
+        for class_info in variants:
+            hooks = " | ".join(f"VARIANT_HOOK_{hook[3:].upper()}" for hook in class_info['hooks']) or "0"
+            code += f"    {hooks}, // {class_info['class_name']}\n"
+        code += "};\n"
+
+        indices = {c['class_name']: i for i, c in enumerate(variants)}
+        integrations = [(indices[c['class_name']], indices[c['integrate_into']], c) for c in variants if c.get('integrate_into')]
+
+        code += f"\nconstexpr std::array<VariantIntegration, {len(integrations)}> VARIANT_INTEGRATIONS = {{{{\n"
+        for source, target, class_info in integrations:
+            code += f"    {{ {source}, {target} }}, // {class_info['class_name']} into {class_info['integrate_into']}\n"
+        code += "}};\n"
+
+        return code
+
+    @staticmethod
+    def generate_variant_access_header(classes_info: List[Dict[str, Any]]) -> str:
+        variants = CodeGenerator.sorted_variants(classes_info)
+        indices = {c['class_name']: i for i, c in enumerate(variants)}
+
+        def to_mask(names) -> int:
+            mask = 0
+            for name in names:
+                if name in indices:
+                    mask |= 1 << indices[name]
+            return mask
+
+        code = "#pragma once\n\n"
+        code += '#include "variant/variant_access.h"\n\n'
+        code += "constexpr VariantAccess VARIANT_ACCESS[VARIANT_TYPE_COUNT] = {\n"
+
+        for class_info in variants:
+            access = class_info['access']
+            exclusive = access['exclusive'] or class_info['ignore_queries'] or class_info.get('main_thread', False)
+
+            code += f"    {{ 0x{to_mask(access['reads']):016x}ull, 0x{to_mask(access['writes']):016x}ull, {'true' if exclusive else 'false'} }}, // {class_info['class_name']}\n"
+
+        code += "};\n"
+        return code
+
+    @staticmethod
+    def generate_variant_ops_header(classes_info: List[Dict[str, Any]]) -> str:
+        variants = CodeGenerator.sorted_variants(classes_info)
+
+        code = "#pragma once\n\n"
+        for include in sorted({c['include'] for c in variants}):
+            code += f'#include "{include}"\n'
+        code += '#include "core/storage/variant_arena.h"\n\n'
+
+        code += "const VariantTypeOps VARIANT_TYPE_OPS[VARIANT_TYPE_COUNT] = {\n"
+        for class_info in variants:
+            fields = "".join(f", &{class_info['class_name']}::{name}" for name in CodeGenerator.soa_fields(class_info))
+            code += f"    make_variant_type_ops<{class_info['class_name']}>({fields[2:]}),\n"
+        code += "};\n"
+
+        return code
+
     @staticmethod
     def generate_requires_file(class_name: str, required_variants: List[str], output_dir: str) -> None:
         if not required_variants:
@@ -448,7 +664,12 @@ class RTTRGenerator:
         self.includes.add('#include "rttr/registration.h"')
 
     def process_headers(self) -> None:
-        header_files = glob.glob(os.path.join(self.game_headers_dir, "**/*.h"), recursive=True)
+        # the generated headers declare every variant class, parsing them would register each one again
+        generated_dir = os.path.join(self.game_headers_dir, "generated")
+        header_files = sorted(
+            header_file for header_file in glob.glob(os.path.join(self.game_headers_dir, "**/*.h"), recursive=True)
+            if os.path.commonpath([os.path.abspath(header_file), os.path.abspath(generated_dir)]) != os.path.abspath(generated_dir)
+        )
         
         print(f"Processing {len(header_files)} header files...")
         
@@ -460,6 +681,7 @@ class RTTRGenerator:
             class_infos = self.parser.parse_header(header_file)
             if class_infos:
                 for class_info in class_infos:
+                    class_info['include'] = relative_path.replace('\\', '/')
                     self.classes_info.append(class_info)
                     self.includes.add(f'#include "{relative_path}"')
 
@@ -482,6 +704,7 @@ class RTTRGenerator:
                                 cpp_content = f.read()
                             
                             dependencies = self.parser.extract_query_dependencies(cpp_content)
+                            class_info['access'] = self.parser.extract_play_update_access(cpp_content, class_info['class_name'])
                             
                             for dep in dependencies:
                                 if dep not in class_info['required_variants'] and dep != class_info['class_name']:
@@ -511,6 +734,36 @@ class RTTRGenerator:
         except Exception as e:
             print(f"Error writing RTTR header {output_path}: {e}")
 
+    def generate_variant_types_header(self, output_path: str) -> None:
+        try:
+            os.makedirs(os.path.dirname(output_path), exist_ok=True)
+            with open(output_path, "w") as f:
+                f.write(CodeGenerator.generate_variant_types_header(self.classes_info))
+
+            print(f"Variant type indices written to {output_path}")
+        except Exception as e:
+            print(f"Error writing variant types header {output_path}: {e}")
+
+    def generate_variant_access_header(self, output_path: str) -> None:
+        try:
+            os.makedirs(os.path.dirname(output_path), exist_ok=True)
+            with open(output_path, "w") as f:
+                f.write(CodeGenerator.generate_variant_access_header(self.classes_info))
+
+            print(f"Variant access table written to {output_path}")
+        except Exception as e:
+            print(f"Error writing variant access header {output_path}: {e}")
+
+    def generate_variant_ops_header(self, output_path: str) -> None:
+        try:
+            os.makedirs(os.path.dirname(output_path), exist_ok=True)
+            with open(output_path, "w") as f:
+                f.write(CodeGenerator.generate_variant_ops_header(self.classes_info))
+
+            print(f"Variant type ops written to {output_path}")
+        except Exception as e:
+            print(f"Error writing variant ops header {output_path}: {e}")
+
     def generate_requires_files(self, requires_dir: str) -> None:
         if os.path.exists(requires_dir):
             print(f"Clearing existing requires directory: {requires_dir}")
@@ -537,12 +790,16 @@ class RTTRGenerator:
     def run(self) -> None:
         self.process_headers()
         self.analyze_implementation_files()
+        CodeGenerator.validate_soa(self.classes_info)
 
         output_path = os.path.join(self.game_headers_dir, "generated/rttr_registration.h")
         
         os.makedirs(os.path.dirname(output_path), exist_ok=True)
         
         self.generate_rttr_header(output_path)
+        self.generate_variant_types_header(os.path.join(self.game_headers_dir, "generated/variant_types.h"))
+        self.generate_variant_access_header(os.path.join(self.game_headers_dir, "generated/variant_access.h"))
+        self.generate_variant_ops_header(os.path.join(self.game_headers_dir, "generated/variant_ops.h"))
         
         requires_dir = os.path.join(self.shared_resources_dir, "variants", "requires")
         self.generate_requires_files(requires_dir)
@@ -3,8 +3,8 @@
 #include <random>
 
 uint64_t generate_unique_id() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // seeded once per thread; random_device is a syscall on most platforms
+    thread_local std::mt19937_64 gen(std::random_device{}());
     std::uniform_int_distribution<uint64_t> dis;
 
     return dis(gen);
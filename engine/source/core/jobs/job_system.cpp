@@ -0,0 +1,158 @@
+#include "core/jobs/job_system.h"
+
+#include "config_manager/config_manager.h"
+#include "remote_logger/remote_logger.h"
+
+namespace {
+    // Index of the queue owned by the current thread, 0 is the main thread.
+    thread_local size_t t_queue_index = 0;
+}
+
+JobSystem::JobSystem() {
+    int thread_count = CONFIG_GET("worker_threads", int, 0);
+    if (thread_count <= 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (int i = 0; i < thread_count; i++) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    for (int i = 1; i < thread_count; i++) {
+        m_workers.emplace_back(&JobSystem::worker_loop, this, static_cast<size_t>(i));
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void JobSystem::submit(JobGroup& group, std::function<void()> task) {
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_workers.empty()) {
+        Job job{std::move(task), &group};
+        execute(job);
+        return;
+    }
+
+    WorkQueue& queue = *m_queues[t_queue_index];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(Job{std::move(task), &group});
+    }
+
+    m_queued.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    }
+    m_wake.notify_one();
+}
+
+void JobSystem::wait(JobGroup& group) {
+    while (!group.is_done()) {
+        if (!try_run_one(t_queue_index)) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (group.m_exception) {
+        std::exception_ptr exception = group.m_exception;
+        group.m_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+size_t JobSystem::get_chunk_count(size_t count, size_t min_chunk) const {
+    if (m_workers.empty()) {
+        return 1;
+    }
+
+    // a few chunks per thread so stealing can even out uneven chunks
+    const size_t max_chunks = get_thread_count() * 4;
+    const size_t chunks = count / std::max<size_t>(min_chunk, 1);
+
+    return std::max<size_t>(1, std::min(chunks, max_chunks));
+}
+
+bool JobSystem::pop(size_t queue_index, Job& job) {
+    WorkQueue& queue = *m_queues[queue_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.jobs.empty()) {
+        return false;
+    }
+
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::steal(size_t thief_index, Job& job) {
+    const size_t count = m_queues.size();
+
+    for (size_t offset = 1; offset < count; offset++) {
+        WorkQueue& queue = *m_queues[(thief_index + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.jobs.empty()) {
+            continue;
+        }
+
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+bool JobSystem::try_run_one(size_t queue_index) {
+    Job job;
+    if (pop(queue_index, job) || steal(queue_index, job)) {
+        execute(job);
+        return true;
+    }
+
+    return false;
+}
+
+void JobSystem::execute(Job& job) {
+    try {
+        job.task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(job.group->m_exception_mutex);
+        if (!job.group->m_exception) {
+            job.group->m_exception = std::current_exception();
+        }
+    }
+
+    job.group->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::worker_loop(size_t queue_index) {
+    t_queue_index = queue_index;
+
+    while (m_running) {
+        if (try_run_one(queue_index)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_wake.wait(lock, [this] {
+            return !m_running || m_queued.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
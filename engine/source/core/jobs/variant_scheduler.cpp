@@ -0,0 +1,24 @@
+#include "core/jobs/variant_scheduler.h"
+
+void VariantScheduler::build() {
+    m_batches.clear();
+
+    for (variant_type_index index : get_hooked_variant_types(VARIANT_HOOK_PLAY_UPDATE)) {
+        bool fits = !m_batches.empty();
+
+        if (fits) {
+            for (variant_type_index other : m_batches.back()) {
+                if (access_conflicts(VARIANT_ACCESS[index], VARIANT_ACCESS[other])) {
+                    fits = false;
+                    break;
+                }
+            }
+        }
+
+        if (fits) {
+            m_batches.back().push_back(index);
+        } else {
+            m_batches.push_back({ index });
+        }
+    }
+}
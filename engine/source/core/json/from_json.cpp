@@ -268,7 +268,7 @@ rttr::variant from(entity_id entity_id, const std::filesystem::path& json_path)
 
 namespace rttr_json {
 
-entity_id deserialize_entity(const std::string& entity_json, entity_id& entity, std::vector<rttr::variant>& variants) {
+entity_guid deserialize_entity(const std::string& entity_json, entity_guid& entity, std::vector<rttr::variant>& variants) {
     Document document;
     document.Parse(entity_json.c_str());
     assert(!document.HasParseError());
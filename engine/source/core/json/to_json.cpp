@@ -12,6 +12,7 @@
 #include <rttr/type.h>
 
 #include "entity/entity.h"
+#include "variant/variant_base.h"
 #include "resource_manager/resource_manager.h"
 
 using namespace rapidjson;
@@ -361,7 +362,7 @@ std::string to(rttr::instance obj, const std::string& path) {
 
 namespace rttr_json  {
 
-std::string serialize_entity(const entity_id entity_id, const std::vector<rttr::variant>& variants) {
+std::string serialize_entity(const entity_guid guid, const std::vector<VariantBase*>& variants) {
     if (variants.empty()) {
         std::cerr << "Serializing entity with no variants" << std::endl;
     }
@@ -371,19 +372,20 @@ std::string serialize_entity(const entity_id entity_id, const std::vector<rttr::
         document.SetObject();
         rapidjson::Document::AllocatorType& allocator = document.GetAllocator();
 
-        document.AddMember("entity_id", entity_id, allocator);
+        document.AddMember("entity_id", guid, allocator);
 
         rapidjson::Value variants_array(rapidjson::kArrayType);
 
-        for (const auto& variant : variants) {
-            if (!variant.is_valid()) {
+        for (VariantBase* variant : variants) {
+            if (!variant) {
                 std::cerr << "Invalid variant in serialize_entity" << std::endl;
                 continue;
             }
             
-            const std::string serialized_variant = serialize_value(variant);
+            const rttr::type type = rttr::type::get(*variant);
+            const std::string serialized_variant = serialize_value(*variant);
             if (serialized_variant.empty()) {
-                std::cerr << "Failed to serialize variant of type: " << variant.get_type().get_name().to_string() << std::endl;
+                std::cerr << "Failed to serialize variant of type: " << type.get_name().to_string() << std::endl;
                 continue;
             }
 
@@ -400,7 +402,7 @@ std::string serialize_entity(const entity_id entity_id, const std::vector<rttr::
             }
 
             rapidjson::Value variant_obj(rapidjson::kObjectType);
-            variant_obj.AddMember("type", variant.get_type().get_name().to_string(), allocator);
+            variant_obj.AddMember("type", type.get_name().to_string(), allocator);
 
             rapidjson::Value value_obj(rapidjson::kObjectType);
             value_obj.CopyFrom(variant_document, allocator);
@@ -422,9 +424,9 @@ std::string serialize_entity(const entity_id entity_id, const std::vector<rttr::
     }
 }
 
-std::string serialize_entity(const entity_id entity_id, const std::vector<rttr::variant>& variants, const std::filesystem::path& path) {
+std::string serialize_entity(const entity_guid guid, const std::vector<VariantBase*>& variants, const std::filesystem::path& path) {
     try {
-        std::string json_string = serialize_entity(entity_id, variants);
+        std::string json_string = serialize_entity(guid, variants);
         if (json_string.empty()) {
             std::cerr << "Failed to serialize entity" << std::endl;
             return std::string();
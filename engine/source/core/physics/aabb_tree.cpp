@@ -0,0 +1,271 @@
+#include "core/physics/aabb_tree.h"
+
+#include <algorithm>
+
+int32_t AabbTree::allocate_node() {
+    if (m_free == NULL_NODE) {
+        m_nodes.emplace_back();
+        return static_cast<int32_t>(m_nodes.size() - 1);
+    }
+
+    const int32_t index = m_free;
+    m_free = m_nodes[index].parent;
+
+    m_nodes[index] = Node{};
+    return index;
+}
+
+void AabbTree::free_node(int32_t index) {
+    Node& node = m_nodes[index];
+    node.parent = m_free;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = -1;
+    m_free = index;
+}
+
+int32_t AabbTree::create_proxy(const Aabb& bounds, uint64_t user_data) {
+    const int32_t proxy = allocate_node();
+
+    Node& node = m_nodes[proxy];
+    node.bounds = expand(bounds, m_margin);
+    node.user_data = user_data;
+    node.height = 0;
+
+    insert_leaf(proxy);
+    m_proxy_count++;
+    return proxy;
+}
+
+void AabbTree::destroy_proxy(int32_t proxy) {
+    remove_leaf(proxy);
+    free_node(proxy);
+    m_proxy_count--;
+}
+
+bool AabbTree::move_proxy(int32_t proxy, const Aabb& bounds) {
+    if (contains(m_nodes[proxy].bounds, bounds)) {
+        return false;
+    }
+
+    remove_leaf(proxy);
+    m_nodes[proxy].bounds = expand(bounds, m_margin);
+    insert_leaf(proxy);
+    return true;
+}
+
+void AabbTree::clear() {
+    m_nodes.clear();
+    m_root = NULL_NODE;
+    m_free = NULL_NODE;
+    m_proxy_count = 0;
+}
+
+void AabbTree::insert_leaf(int32_t leaf) {
+    if (m_root == NULL_NODE) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    const Aabb leaf_bounds = m_nodes[leaf].bounds;
+
+    // walk down to the cheapest sibling: a node is worth descending into while
+    // pairing the leaf with one of its children costs less than pairing it here
+    int32_t index = m_root;
+    while (!m_nodes[index].is_leaf()) {
+        const Node& node = m_nodes[index];
+
+        const float area = perimeter(node.bounds);
+        const float combined_area = perimeter(combine(node.bounds, leaf_bounds));
+
+        const float cost = 2.0f * combined_area;
+        // growth every ancestor of a deeper sibling pays as well
+        const float inheritance_cost = 2.0f * (combined_area - area);
+
+        auto descend_cost = [&](int32_t child) {
+            const Node& child_node = m_nodes[child];
+            const float grown = perimeter(combine(leaf_bounds, child_node.bounds));
+            return (child_node.is_leaf() ? grown : grown - perimeter(child_node.bounds)) + inheritance_cost;
+        };
+
+        const float cost1 = descend_cost(node.child1);
+        const float cost2 = descend_cost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int32_t sibling = index;
+    const int32_t old_parent = m_nodes[sibling].parent;
+    const int32_t new_parent = allocate_node();
+
+    Node& parent = m_nodes[new_parent];
+    parent.parent = old_parent;
+    parent.bounds = combine(leaf_bounds, m_nodes[sibling].bounds);
+    parent.height = m_nodes[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+
+    if (old_parent != NULL_NODE) {
+        if (m_nodes[old_parent].child1 == sibling) {
+            m_nodes[old_parent].child1 = new_parent;
+        } else {
+            m_nodes[old_parent].child2 = new_parent;
+        }
+    } else {
+        m_root = new_parent;
+    }
+
+    m_nodes[sibling].parent = new_parent;
+    m_nodes[leaf].parent = new_parent;
+
+    fix_upwards(m_nodes[leaf].parent);
+}
+
+void AabbTree::remove_leaf(int32_t leaf) {
+    if (leaf == m_root) {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    const int32_t parent = m_nodes[leaf].parent;
+    const int32_t grand_parent = m_nodes[parent].parent;
+    const int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grand_parent == NULL_NODE) {
+        m_root = sibling;
+        m_nodes[sibling].parent = NULL_NODE;
+        free_node(parent);
+        return;
+    }
+
+    if (m_nodes[grand_parent].child1 == parent) {
+        m_nodes[grand_parent].child1 = sibling;
+    } else {
+        m_nodes[grand_parent].child2 = sibling;
+    }
+
+    m_nodes[sibling].parent = grand_parent;
+    free_node(parent);
+
+    fix_upwards(grand_parent);
+}
+
+void AabbTree::fix_upwards(int32_t index) {
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        Node& node = m_nodes[index];
+        const Node& child1 = m_nodes[node.child1];
+        const Node& child2 = m_nodes[node.child2];
+
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.bounds = combine(child1.bounds, child2.bounds);
+
+        index = node.parent;
+    }
+}
+
+int32_t AabbTree::balance(int32_t index_a) {
+    Node& a = m_nodes[index_a];
+    if (a.is_leaf() || a.height < 2) {
+        return index_a;
+    }
+
+    const int32_t index_b = a.child1;
+    const int32_t index_c = a.child2;
+    Node& b = m_nodes[index_b];
+    Node& c = m_nodes[index_c];
+
+    const int32_t lean = c.height - b.height;
+
+    // rotate c up
+    if (lean > 1) {
+        const int32_t index_f = c.child1;
+        const int32_t index_g = c.child2;
+        Node& f = m_nodes[index_f];
+        Node& g = m_nodes[index_g];
+
+        c.child1 = index_a;
+        c.parent = a.parent;
+        a.parent = index_c;
+
+        if (c.parent != NULL_NODE) {
+            if (m_nodes[c.parent].child1 == index_a) {
+                m_nodes[c.parent].child1 = index_c;
+            } else {
+                m_nodes[c.parent].child2 = index_c;
+            }
+        } else {
+            m_root = index_c;
+        }
+
+        if (f.height > g.height) {
+            c.child2 = index_f;
+            a.child2 = index_g;
+            g.parent = index_a;
+            a.bounds = combine(b.bounds, g.bounds);
+            c.bounds = combine(a.bounds, f.bounds);
+            a.height = 1 + std::max(b.height, g.height);
+            c.height = 1 + std::max(a.height, f.height);
+        } else {
+            c.child2 = index_g;
+            a.child2 = index_f;
+            f.parent = index_a;
+            a.bounds = combine(b.bounds, f.bounds);
+            c.bounds = combine(a.bounds, g.bounds);
+            a.height = 1 + std::max(b.height, f.height);
+            c.height = 1 + std::max(a.height, g.height);
+        }
+
+        return index_c;
+    }
+
+    // rotate b up
+    if (lean < -1) {
+        const int32_t index_d = b.child1;
+        const int32_t index_e = b.child2;
+        Node& d = m_nodes[index_d];
+        Node& e = m_nodes[index_e];
+
+        b.child1 = index_a;
+        b.parent = a.parent;
+        a.parent = index_b;
+
+        if (b.parent != NULL_NODE) {
+            if (m_nodes[b.parent].child1 == index_a) {
+                m_nodes[b.parent].child1 = index_b;
+            } else {
+                m_nodes[b.parent].child2 = index_b;
+            }
+        } else {
+            m_root = index_b;
+        }
+
+        if (d.height > e.height) {
+            b.child2 = index_d;
+            a.child1 = index_e;
+            e.parent = index_a;
+            a.bounds = combine(c.bounds, e.bounds);
+            b.bounds = combine(a.bounds, d.bounds);
+            a.height = 1 + std::max(c.height, e.height);
+            b.height = 1 + std::max(a.height, d.height);
+        } else {
+            b.child2 = index_e;
+            a.child1 = index_d;
+            d.parent = index_a;
+            a.bounds = combine(c.bounds, d.bounds);
+            b.bounds = combine(a.bounds, e.bounds);
+            a.height = 1 + std::max(c.height, d.height);
+            b.height = 1 + std::max(a.height, e.height);
+        }
+
+        return index_b;
+    }
+
+    return index_a;
+}
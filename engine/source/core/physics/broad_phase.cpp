@@ -0,0 +1,195 @@
+#include "core/physics/broad_phase.h"
+
+#include <algorithm>
+
+namespace {
+    inline bool same_bounds(const Aabb& a, const Aabb& b) {
+        return a.min.x == b.min.x && a.min.y == b.min.y && a.max.x == b.max.x && a.max.y == b.max.y;
+    }
+}
+
+void BroadPhase::set_type(BroadPhaseType type) {
+    if (type == m_type) {
+        return;
+    }
+
+    m_type = type;
+    reset();
+}
+
+void BroadPhase::reset() {
+    m_tree.clear();
+    m_static_tree.clear();
+    m_grid.clear();
+    m_tracked.clear();
+    m_tracked_indices.clear();
+    m_body_bounds.clear();
+    m_dynamic_bodies.clear();
+}
+
+void BroadPhase::begin_step() {
+    m_step++;
+    m_body_bounds.clear();
+    m_dynamic_bodies.clear();
+
+    if (m_type == BroadPhaseType::Grid) {
+        m_grid.clear();
+    }
+}
+
+void BroadPhase::update(uint32_t body, entity_id owner, const Aabb& bounds, bool is_static) {
+    if (body >= m_body_bounds.size()) {
+        m_body_bounds.resize(body + 1);
+    }
+    m_body_bounds[body] = bounds;
+
+    const uint32_t index = get_entity_index(owner);
+    if (index >= m_tracked.size()) {
+        m_tracked.resize(index + 1);
+    }
+
+    TrackedProxy& tracked = m_tracked[index];
+    const bool was_tracked = tracked.proxy != AabbTree::NULL_NODE;
+
+    // the entity slot was reused since the proxy was made, or the body changed trees
+    if (was_tracked && (tracked.owner != owner || tracked.is_static != is_static)) {
+        destroy_proxy(tracked);
+    }
+
+    tracked.owner = owner;
+    tracked.step = m_step;
+    tracked.is_static = is_static;
+
+    if (is_static) {
+        update_static(body, tracked, bounds);
+    } else {
+        m_dynamic_bodies.push_back(body);
+        update_dynamic(body, tracked, bounds);
+    }
+
+    if (!was_tracked && tracked.proxy != AabbTree::NULL_NODE) {
+        m_tracked_indices.push_back(index);
+    }
+}
+
+void BroadPhase::update_dynamic(uint32_t body, TrackedProxy& tracked, const Aabb& bounds) {
+    if (m_type == BroadPhaseType::Grid) {
+        m_grid.insert(body, bounds);
+        return;
+    }
+
+    if (tracked.proxy == AabbTree::NULL_NODE) {
+        tracked.proxy = m_tree.create_proxy(bounds, tracked.owner);
+    } else {
+        m_tree.move_proxy(tracked.proxy, bounds);
+    }
+
+    if (m_tree.get_node_capacity() > m_proxy_bodies.size()) {
+        m_proxy_bodies.resize(m_tree.get_node_capacity());
+    }
+    m_proxy_bodies[tracked.proxy] = body;
+}
+
+void BroadPhase::update_static(uint32_t body, TrackedProxy& tracked, const Aabb& bounds) {
+    if (tracked.proxy != AabbTree::NULL_NODE && !same_bounds(tracked.bounds, bounds)) {
+        m_static_tree.destroy_proxy(tracked.proxy);
+        tracked.proxy = AabbTree::NULL_NODE;
+    }
+
+    if (tracked.proxy == AabbTree::NULL_NODE) {
+        tracked.proxy = m_static_tree.create_proxy(bounds, tracked.owner);
+        tracked.bounds = bounds;
+    }
+
+    if (m_static_tree.get_node_capacity() > m_static_proxy_bodies.size()) {
+        m_static_proxy_bodies.resize(m_static_tree.get_node_capacity());
+    }
+    m_static_proxy_bodies[tracked.proxy] = body;
+}
+
+void BroadPhase::destroy_proxy(TrackedProxy& tracked) {
+    if (tracked.is_static) {
+        m_static_tree.destroy_proxy(tracked.proxy);
+    } else if (m_type == BroadPhaseType::AabbTree) {
+        m_tree.destroy_proxy(tracked.proxy);
+    }
+
+    tracked.proxy = AabbTree::NULL_NODE;
+}
+
+void BroadPhase::find_pairs(std::vector<ProxyPair>& pairs) {
+    drop_unreported();
+
+    find_dynamic_pairs(pairs);
+    find_static_pairs(pairs);
+}
+
+void BroadPhase::find_dynamic_pairs(std::vector<ProxyPair>& pairs) {
+    if (m_type == BroadPhaseType::Grid) {
+        m_grid.build();
+        m_grid.find_pairs(pairs);
+        return;
+    }
+
+    for (uint32_t body : m_dynamic_bodies) {
+        const Aabb& bounds = m_body_bounds[body];
+
+        m_tree.query(bounds, [&](int32_t proxy) {
+            // each pair is found from both sides, keep the lower body's find
+            const uint32_t other = m_proxy_bodies[proxy];
+            if (other > body && overlaps(bounds, m_body_bounds[other])) {
+                pairs.push_back(ProxyPair{ body, other });
+            }
+        });
+    }
+}
+
+void BroadPhase::find_static_pairs(std::vector<ProxyPair>& pairs) {
+    if (m_static_tree.get_proxy_count() == 0) {
+        return;
+    }
+
+    for (uint32_t body : m_dynamic_bodies) {
+        const Aabb& bounds = m_body_bounds[body];
+
+        m_static_tree.query(bounds, [&](int32_t proxy) {
+            const uint32_t other = m_static_proxy_bodies[proxy];
+            pairs.push_back(ProxyPair{ std::min(body, other), std::max(body, other) });
+        });
+    }
+}
+
+void BroadPhase::query(const Aabb& bounds, std::vector<uint32_t>& bodies) const {
+    if (m_type == BroadPhaseType::Grid) {
+        m_grid.query(bounds, bodies);
+    } else {
+        m_tree.query(bounds, [&](int32_t proxy) {
+            const uint32_t body = m_proxy_bodies[proxy];
+            if (overlaps(bounds, m_body_bounds[body])) {
+                bodies.push_back(body);
+            }
+        });
+    }
+
+    m_static_tree.query(bounds, [&](int32_t proxy) {
+        bodies.push_back(m_static_proxy_bodies[proxy]);
+    });
+}
+
+void BroadPhase::drop_unreported() {
+    for (size_t i = 0; i < m_tracked_indices.size();) {
+        TrackedProxy& tracked = m_tracked[m_tracked_indices[i]];
+        if (tracked.step == m_step && tracked.proxy != AabbTree::NULL_NODE) {
+            i++;
+            continue;
+        }
+
+        if (tracked.proxy != AabbTree::NULL_NODE) {
+            destroy_proxy(tracked);
+        }
+        tracked = TrackedProxy{};
+
+        m_tracked_indices[i] = m_tracked_indices.back();
+        m_tracked_indices.pop_back();
+    }
+}
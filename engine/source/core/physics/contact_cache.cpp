@@ -0,0 +1,69 @@
+#include "core/physics/contact_cache.h"
+
+#include <algorithm>
+
+namespace {
+    inline bool contact_less(const Contact& lhs, const Contact& rhs) {
+        return lhs.a != rhs.a ? lhs.a < rhs.a : lhs.b < rhs.b;
+    }
+}
+
+void ContactCache::begin_step() {
+    m_current.clear();
+}
+
+void ContactCache::add(entity_id a, entity_id b, uint32_t body_a, uint32_t body_b) {
+    if (b < a) {
+        m_current.push_back(Contact{ b, a, body_b, body_a });
+    } else {
+        m_current.push_back(Contact{ a, b, body_a, body_b });
+    }
+}
+
+void ContactCache::update() {
+    std::sort(m_current.begin(), m_current.end(), contact_less);
+
+    m_entered.clear();
+    m_stayed.clear();
+    m_exited.clear();
+
+    size_t previous = 0;
+    size_t current = 0;
+    while (previous < m_previous.size() && current < m_current.size()) {
+        if (contact_less(m_previous[previous], m_current[current])) {
+            m_exited.push_back(m_previous[previous++]);
+        } else if (contact_less(m_current[current], m_previous[previous])) {
+            m_entered.push_back(m_current[current++]);
+        } else {
+            m_stayed.push_back(m_current[current++]);
+            previous++;
+        }
+    }
+
+    m_exited.insert(m_exited.end(), m_previous.begin() + previous, m_previous.end());
+    m_entered.insert(m_entered.end(), m_current.begin() + current, m_current.end());
+
+    m_previous.swap(m_current);
+}
+
+bool ContactCache::add_entered(entity_id a, entity_id b, uint32_t body_a, uint32_t body_b) {
+    const Contact contact = b < a ? Contact{ b, a, body_b, body_a } : Contact{ a, b, body_a, body_b };
+
+    // after update the previous step's set holds this step's contacts
+    auto it = std::lower_bound(m_previous.begin(), m_previous.end(), contact, contact_less);
+    if (it != m_previous.end() && !contact_less(contact, *it)) {
+        return false;
+    }
+
+    m_previous.insert(it, contact);
+    m_entered.push_back(contact);
+    return true;
+}
+
+void ContactCache::clear() {
+    m_previous.clear();
+    m_current.clear();
+    m_entered.clear();
+    m_stayed.clear();
+    m_exited.clear();
+}
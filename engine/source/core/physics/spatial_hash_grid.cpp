@@ -0,0 +1,112 @@
+#include "core/physics/spatial_hash_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // keeps far away boxes from overflowing the cell coordinates
+    constexpr float MAX_CELL = 1.0e9f;
+
+    inline int32_t to_cell(float value, float cell_size) {
+        return static_cast<int32_t>(std::clamp(std::floor(value / cell_size), -MAX_CELL, MAX_CELL));
+    }
+
+    inline uint64_t make_cell(int32_t x, int32_t y) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+}
+
+void SpatialHashGrid::clear() {
+    if (m_next_cell_size > 0.0f) {
+        m_cell_size = m_next_cell_size;
+        m_next_cell_size = 0.0f;
+    }
+
+    m_entries.clear();
+    m_proxies = 0;
+}
+
+SpatialHashGrid::CellRange SpatialHashGrid::get_cells(const Aabb& bounds) const {
+    return CellRange{
+        to_cell(bounds.min.x, m_cell_size),
+        to_cell(bounds.min.y, m_cell_size),
+        to_cell(bounds.max.x, m_cell_size),
+        to_cell(bounds.max.y, m_cell_size)
+    };
+}
+
+void SpatialHashGrid::insert(uint32_t proxy, const Aabb& bounds) {
+    if (proxy >= m_bounds.size()) {
+        m_bounds.resize(proxy + 1);
+    }
+
+    m_bounds[proxy] = bounds;
+    m_proxies++;
+
+    const CellRange cells = get_cells(bounds);
+    for (int32_t y = cells.min_y; y <= cells.max_y; y++) {
+        for (int32_t x = cells.min_x; x <= cells.max_x; x++) {
+            m_entries.push_back(Entry{ make_cell(x, y), proxy });
+        }
+    }
+}
+
+void SpatialHashGrid::build() {
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+        return a.cell != b.cell ? a.cell < b.cell : a.proxy < b.proxy;
+    });
+}
+
+bool SpatialHashGrid::owns_overlap(uint64_t cell, const Aabb& a, const Aabb& b) const {
+    const float corner_x = std::max(a.min.x, b.min.x);
+    const float corner_y = std::max(a.min.y, b.min.y);
+    return make_cell(to_cell(corner_x, m_cell_size), to_cell(corner_y, m_cell_size)) == cell;
+}
+
+void SpatialHashGrid::find_pairs(std::vector<ProxyPair>& pairs) const {
+    size_t begin = 0;
+    while (begin < m_entries.size()) {
+        const uint64_t cell = m_entries[begin].cell;
+
+        size_t end = begin + 1;
+        while (end < m_entries.size() && m_entries[end].cell == cell) {
+            end++;
+        }
+
+        // entries of a cell are sorted by proxy, so i < j gives the lower id first
+        for (size_t i = begin; i < end; i++) {
+            const uint32_t a = m_entries[i].proxy;
+
+            for (size_t j = i + 1; j < end; j++) {
+                const uint32_t b = m_entries[j].proxy;
+
+                if (overlaps(m_bounds[a], m_bounds[b]) && owns_overlap(cell, m_bounds[a], m_bounds[b])) {
+                    pairs.push_back(ProxyPair{ a, b });
+                }
+            }
+        }
+
+        begin = end;
+    }
+}
+
+void SpatialHashGrid::query(const Aabb& bounds, std::vector<uint32_t>& results) const {
+    const CellRange cells = get_cells(bounds);
+
+    for (int32_t y = cells.min_y; y <= cells.max_y; y++) {
+        for (int32_t x = cells.min_x; x <= cells.max_x; x++) {
+            const uint64_t cell = make_cell(x, y);
+
+            auto it = std::lower_bound(m_entries.begin(), m_entries.end(), cell, [](const Entry& entry, uint64_t value) {
+                return entry.cell < value;
+            });
+
+            for (; it != m_entries.end() && it->cell == cell; ++it) {
+                const Aabb& other = m_bounds[it->proxy];
+                if (overlaps(bounds, other) && owns_overlap(cell, bounds, other)) {
+                    results.push_back(it->proxy);
+                }
+            }
+        }
+    }
+}
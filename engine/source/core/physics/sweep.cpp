@@ -0,0 +1,85 @@
+#include "core/physics/sweep.h"
+
+#include <cmath>
+#include <utility>
+
+namespace {
+    constexpr float NO_HIT = -1.0f;
+    constexpr float EPSILON = 1.0e-6f;
+
+    // First t in [0, 1] where start + motion * t is radius away from center.
+    float ray_circle(Vector2 start, Vector2 motion, Vector2 center, float radius) {
+        const Vector2 offset = { start.x - center.x, start.y - center.y };
+
+        const float a = motion.x * motion.x + motion.y * motion.y;
+        const float b = offset.x * motion.x + offset.y * motion.y;
+        const float c = offset.x * offset.x + offset.y * offset.y - radius * radius;
+
+        if (c < 0.0f || a < EPSILON || b >= 0.0f) {
+            return NO_HIT;
+        }
+
+        const float discriminant = b * b - a * c;
+        if (discriminant < 0.0f) {
+            return NO_HIT;
+        }
+
+        const float t = (-b - std::sqrt(discriminant)) / a;
+        return t <= 1.0f ? t : NO_HIT;
+    }
+
+    // Entry t of start + motion * t into box along one axis, narrowing [t_min, t_max].
+    bool clip_slab(float start, float motion, float min, float max, float& t_min, float& t_max) {
+        if (std::fabs(motion) < EPSILON) {
+            return min <= start && start <= max;
+        }
+
+        float t0 = (min - start) / motion;
+        float t1 = (max - start) / motion;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+
+        t_min = std::fmax(t_min, t0);
+        t_max = std::fmin(t_max, t1);
+        return t_min <= t_max;
+    }
+}
+
+float sweep_circle_aabb(Vector2 center, float radius, Vector2 motion, const Aabb& box) {
+    const float closest_x = std::fmax(box.min.x, std::fmin(center.x, box.max.x));
+    const float closest_y = std::fmax(box.min.y, std::fmin(center.y, box.max.y));
+    const float dx = center.x - closest_x;
+    const float dy = center.y - closest_y;
+    if (dx * dx + dy * dy <= radius * radius) {
+        return NO_HIT;
+    }
+
+    const Aabb grown = expand(box, radius);
+
+    float t_min = 0.0f;
+    float t_max = 1.0f;
+    if (!clip_slab(center.x, motion.x, grown.min.x, grown.max.x, t_min, t_max) ||
+        !clip_slab(center.y, motion.y, grown.min.y, grown.max.y, t_min, t_max)) {
+        return NO_HIT;
+    }
+
+    // entering the grown box next to a face hits that face; entering one of its
+    // corner squares hits the rounded corner or nothing at all
+    const Vector2 hit = { center.x + motion.x * t_min, center.y + motion.y * t_min };
+    const bool beside_x = hit.x < box.min.x || hit.x > box.max.x;
+    const bool beside_y = hit.y < box.min.y || hit.y > box.max.y;
+    if (!beside_x || !beside_y) {
+        return t_min;
+    }
+
+    const Vector2 corner = {
+        hit.x < box.min.x ? box.min.x : box.max.x,
+        hit.y < box.min.y ? box.min.y : box.max.y
+    };
+    return ray_circle(center, motion, corner, radius);
+}
+
+float sweep_circle_circle(Vector2 center, float radius, Vector2 motion, Vector2 other_center, float other_radius) {
+    return ray_circle(center, motion, other_center, radius + other_radius);
+}
@@ -0,0 +1,152 @@
+#include "core/storage/command_buffer.h"
+
+#include <algorithm>
+
+#include "core/storage/variant_storage.h"
+#include "variant/variant_base.h"
+#include "remote_logger/remote_logger.h"
+
+CommandBuffer::CommandBuffer(VariantStorage& storage) : m_storage(storage) {
+    m_staging.resize(VARIANT_TYPE_COUNT);
+}
+
+CommandBuffer::~CommandBuffer() {
+    clear();
+}
+
+entity_id CommandBuffer::create_entity() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return record_create();
+}
+
+entity_id CommandBuffer::record_create() {
+    const entity_id id = m_storage.reserve_entity();
+    m_commands.push_back(Command{ CommandType::Create, id, INVALID_VARIANT_TYPE, nullptr });
+    return id;
+}
+
+void CommandBuffer::remove(entity_id id, variant_type_index index) {
+    record(CommandType::Remove, id, index);
+}
+
+void CommandBuffer::destroy(entity_id id) {
+    record(CommandType::Destroy, id, INVALID_VARIANT_TYPE);
+}
+
+void CommandBuffer::record(CommandType type, entity_id id, variant_type_index index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commands.push_back(Command{ type, id, index, nullptr });
+}
+
+bool CommandBuffer::can_spawn_batch(size_t count, bool has_singleton) const {
+    if (count > 1 && has_singleton) {
+        log_error() << "Cannot spawn a batch of " << count << " entities with a singleton variant" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+VariantArena& CommandBuffer::get_staging(variant_type_index index) {
+    auto& arena = m_staging[index];
+    if (!arena) {
+        const VariantTypeOps& ops = get_variant_type_ops(index);
+        arena = std::make_unique<VariantArena>(ops.size, ops.alignment);
+    }
+
+    return *arena;
+}
+
+void CommandBuffer::release_staged(const Command& command) {
+    const VariantTypeOps& ops = get_variant_type_ops(command.index);
+    if (ops.destroy) {
+        ops.destroy(command.variant);
+    }
+
+    m_staging[command.index]->deallocate(command.variant);
+}
+
+void CommandBuffer::apply() {
+    std::vector<Command> commands;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        commands.swap(m_commands);
+    }
+
+    if (commands.empty()) {
+        return;
+    }
+
+    // grow every pool once for the whole batch instead of once per add
+    std::vector<size_t> added(VARIANT_TYPE_COUNT, 0);
+    for (const Command& command : commands) {
+        if (command.type == CommandType::Add) {
+            added[command.index]++;
+        }
+    }
+
+    for (variant_type_index index = 0; index < VARIANT_TYPE_COUNT; index++) {
+        if (added[index] == 0) continue;
+
+        VariantPool& pool = m_storage.get_pool(index);
+        const size_t needed = pool.size() + added[index];
+        if (needed > pool.capacity()) {
+            pool.reserve(std::max(needed, pool.capacity() * 2));
+        }
+    }
+
+    for (Command& command : commands) {
+        switch (command.type) {
+            case CommandType::Create:
+                if (!m_storage.create_reserved_entity(command.id)) {
+                    log_warning() << "Dropping an entity reserved before the scene was cleared" << std::endl;
+                }
+                break;
+            case CommandType::Add: {
+                VariantBase* stored = nullptr;
+
+                // the entity may have been destroyed earlier in the batch
+                if (m_storage.has_entity(command.id)) {
+                    if (m_storage.has_variant(command.id, command.index)) {
+                        log_warning() << "Trying to add duplicate variants to entity" << std::endl;
+                    } else {
+                        stored = m_storage.add_variant(command.id, command.index, *command.variant);
+                    }
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    release_staged(command);
+                }
+
+                // on_init may record more commands, so it runs outside the lock
+                if (stored) {
+                    stored->on_init();
+                }
+                break;
+            }
+            case CommandType::Remove:
+                m_storage.remove_variant(command.id, command.index);
+                break;
+            case CommandType::Destroy:
+                m_storage.remove_entity(command.id);
+                break;
+        }
+    }
+}
+
+void CommandBuffer::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Command& command : m_commands) {
+        if (command.type == CommandType::Add) {
+            release_staged(command);
+        }
+    }
+
+    m_commands.clear();
+}
+
+bool CommandBuffer::empty() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_commands.empty();
+}
@@ -0,0 +1,82 @@
+#include "core/storage/variant_arena.h"
+
+#include <algorithm>
+
+#include "game/generated/variant_ops.h"
+
+namespace {
+    constexpr size_t SLAB_BYTES = 16 * 1024;
+    constexpr size_t MIN_SLAB_CAPACITY = 16;
+}
+
+VariantArena::VariantArena(size_t size, size_t alignment)
+    : m_alignment(std::max(alignment, alignof(FreeNode))) {
+    m_stride = std::max(size, sizeof(FreeNode));
+    m_stride = (m_stride + m_alignment - 1) / m_alignment * m_alignment;
+    m_slab_capacity = std::max(SLAB_BYTES / m_stride, MIN_SLAB_CAPACITY);
+}
+
+VariantArena::~VariantArena() {
+    release();
+}
+
+void* VariantArena::allocate() {
+    if (m_free) {
+        FreeNode* node = m_free;
+        m_free = node->next;
+        return node;
+    }
+
+    if (m_cursor == m_end) {
+        add_slab(m_slab_capacity);
+    }
+
+    void* memory = m_cursor;
+    m_cursor += m_stride;
+    return memory;
+}
+
+void VariantArena::deallocate(void* memory) {
+    FreeNode* node = static_cast<FreeNode*>(memory);
+    node->next = m_free;
+    m_free = node;
+}
+
+void VariantArena::reserve(size_t count) {
+    size_t available = static_cast<size_t>(m_end - m_cursor) / m_stride;
+    for (FreeNode* node = m_free; node && available < count; node = node->next) {
+        available++;
+    }
+
+    if (available < count) {
+        add_slab(std::max(count - available, m_slab_capacity));
+    }
+}
+
+void VariantArena::release() {
+    for (void* slab : m_slabs) {
+        ::operator delete(slab, std::align_val_t(m_alignment));
+    }
+
+    m_slabs.clear();
+    m_cursor = nullptr;
+    m_end = nullptr;
+    m_free = nullptr;
+}
+
+void VariantArena::add_slab(size_t count) {
+    // what is left of the current slab stays usable through the free list
+    while (m_cursor != m_end) {
+        deallocate(m_cursor);
+        m_cursor += m_stride;
+    }
+
+    std::byte* slab = static_cast<std::byte*>(::operator new(count * m_stride, std::align_val_t(m_alignment)));
+    m_slabs.push_back(slab);
+    m_cursor = slab;
+    m_end = slab + count * m_stride;
+}
+
+const VariantTypeOps& get_variant_type_ops(variant_type_index index) {
+    return VARIANT_TYPE_OPS[index];
+}
@@ -0,0 +1,53 @@
+#include "core/storage/variant_integrator.h"
+
+#include "core/jobs/job_system.h"
+#include "core/storage/variant_storage.h"
+#include "variant/variant_base.h"
+
+namespace {
+    constexpr size_t MIN_CHUNK = 4096;
+}
+
+void VariantIntegrator::run(VariantStorage& storage, float dt) {
+    for (const VariantIntegration& integration : VARIANT_INTEGRATIONS) {
+        VariantPool* target = storage.find_pool(integration.target);
+        const VariantPool* source = storage.find_pool(integration.source);
+        if (!target || !source || target->empty() || source->empty()) continue;
+
+        integrate(*target, *source, dt, storage.get_tick());
+    }
+}
+
+void VariantIntegrator::integrate(VariantPool& target, const VariantPool& source, float dt, uint32_t tick) {
+    const size_t fields = target.get_soa_field_count();
+    const std::vector<entity_id>& entities = target.get_entities();
+    const std::vector<VariantBase*>& variants = target.get_variants();
+
+    float VariantBase::* target_fields[MAX_SOA_FIELDS];
+    float VariantBase::* source_fields[MAX_SOA_FIELDS];
+    for (size_t field = 0; field < fields; field++) {
+        target_fields[field] = target.get_soa_field(field);
+        source_fields[field] = source.get_soa_field(field);
+    }
+
+    JobSystem::get().parallel_for(target.size(), MIN_CHUNK, [&](size_t begin, size_t end) {
+        for (size_t slot = begin; slot < end; slot++) {
+            // dead variants wait for reclaim_dead_variants and are left alone, as are targets without a source
+            VariantBase* value = variants[slot];
+            if (value->is_dead) {
+                continue;
+            }
+
+            const VariantBase* rate = source.find(entities[slot]);
+            if (!rate || rate->is_dead) {
+                continue;
+            }
+
+            for (size_t field = 0; field < fields; field++) {
+                value->*target_fields[field] += rate->*source_fields[field] * dt;
+            }
+
+            target.mark_changed(slot, tick);
+        }
+    });
+}
@@ -0,0 +1,214 @@
+#include "core/storage/variant_pool.h"
+
+#include "variant/variant_base.h"
+
+VariantPool::~VariantPool() {
+    clear();
+}
+
+uint32_t VariantPool::find_slot(entity_id id) const {
+    const uint32_t index = get_entity_index(id);
+    if (index >= m_sparse.size()) {
+        return INVALID_SLOT;
+    }
+
+    const uint32_t slot = m_sparse[index];
+    if (slot == INVALID_SLOT || m_entities[slot] != id) {
+        return INVALID_SLOT;
+    }
+
+    return slot;
+}
+
+bool VariantPool::contains(entity_id id) const {
+    return find_slot(id) != INVALID_SLOT;
+}
+
+VariantBase* VariantPool::find(entity_id id) {
+    const uint32_t slot = find_slot(id);
+    return slot != INVALID_SLOT ? m_variants[slot] : nullptr;
+}
+
+const VariantBase* VariantPool::find(entity_id id) const {
+    const uint32_t slot = find_slot(id);
+    return slot != INVALID_SLOT ? m_variants[slot] : nullptr;
+}
+
+VariantBase* VariantPool::find_for_write(entity_id id, uint32_t tick) {
+    const uint32_t slot = find_slot(id);
+    if (slot == INVALID_SLOT) {
+        return nullptr;
+    }
+
+    m_changed_ticks[slot] = tick;
+    return m_variants[slot];
+}
+
+VariantBase* VariantPool::insert(entity_id id, VariantBase& variant, uint32_t tick) {
+    const uint32_t existing = find_slot(id);
+    if (existing != INVALID_SLOT) {
+        return m_variants[existing];
+    }
+
+    return push(id, m_ops.move_construct(m_arena.allocate(), variant), tick);
+}
+
+VariantBase* VariantPool::emplace(entity_id id, uint32_t tick) {
+    const uint32_t existing = find_slot(id);
+    if (existing != INVALID_SLOT) {
+        return m_variants[existing];
+    }
+
+    VariantBase* instance = m_ops.default_construct(m_arena.allocate());
+    instance->entity_id = id;
+    return push(id, instance, tick);
+}
+
+VariantBase* VariantPool::push(entity_id id, VariantBase* instance, uint32_t tick) {
+    const uint32_t index = get_entity_index(id);
+    if (index >= m_sparse.size()) {
+        m_sparse.resize(index + 1, INVALID_SLOT);
+    }
+
+    m_sparse[index] = static_cast<uint32_t>(m_variants.size());
+    m_entities.push_back(id);
+    m_added_ticks.push_back(tick);
+    m_changed_ticks.push_back(tick);
+    m_variants.push_back(instance);
+    for (size_t field = 0; field < m_previous.size(); field++) {
+        m_previous[field].push_back(instance->*m_ops.soa_fields[field]);
+    }
+
+    return instance;
+}
+
+void VariantPool::destroy(VariantBase* instance) {
+    if (m_ops.destroy) {
+        m_ops.destroy(instance);
+    }
+
+    m_arena.deallocate(instance);
+}
+
+void VariantPool::erase(entity_id id) {
+    const uint32_t slot = find_slot(id);
+    if (slot == INVALID_SLOT) {
+        return;
+    }
+
+    destroy(m_variants[slot]);
+
+    const size_t last = m_variants.size() - 1;
+
+    if (slot != last) {
+        m_variants[slot] = m_variants[last];
+        m_entities[slot] = m_entities[last];
+        m_added_ticks[slot] = m_added_ticks[last];
+        m_changed_ticks[slot] = m_changed_ticks[last];
+        for (auto& previous : m_previous) {
+            previous[slot] = previous[last];
+        }
+        m_sparse[get_entity_index(m_entities[slot])] = slot;
+    }
+
+    m_variants.pop_back();
+    m_entities.pop_back();
+    m_added_ticks.pop_back();
+    m_changed_ticks.pop_back();
+    for (auto& previous : m_previous) {
+        previous.pop_back();
+    }
+    m_sparse[get_entity_index(id)] = INVALID_SLOT;
+}
+
+void VariantPool::reserve(size_t capacity) {
+    if (capacity > m_variants.size()) {
+        m_arena.reserve(capacity - m_variants.size());
+    }
+
+    m_variants.reserve(capacity);
+    m_entities.reserve(capacity);
+    m_added_ticks.reserve(capacity);
+    m_changed_ticks.reserve(capacity);
+    for (auto& previous : m_previous) {
+        previous.reserve(capacity);
+    }
+}
+
+void VariantPool::compact() {
+    if (m_variants.empty()) {
+        m_arena.release();
+    }
+
+    while (!m_sparse.empty() && m_sparse.back() == INVALID_SLOT) {
+        m_sparse.pop_back();
+    }
+
+    if (m_sparse.size() < m_sparse.capacity() / 4) {
+        m_sparse.shrink_to_fit();
+    }
+
+    if (m_variants.size() < m_variants.capacity() / 4) {
+        m_variants.shrink_to_fit();
+        m_entities.shrink_to_fit();
+        m_added_ticks.shrink_to_fit();
+        m_changed_ticks.shrink_to_fit();
+        for (auto& previous : m_previous) {
+            previous.shrink_to_fit();
+        }
+    }
+}
+
+void VariantPool::clear() {
+    if (m_ops.destroy) {
+        for (VariantBase* instance : m_variants) {
+            m_ops.destroy(instance);
+        }
+    }
+
+    m_arena.release();
+    m_variants.clear();
+    m_entities.clear();
+    m_added_ticks.clear();
+    m_changed_ticks.clear();
+    m_sparse.clear();
+    for (auto& previous : m_previous) {
+        previous.clear();
+    }
+}
+
+void VariantPool::save_previous() {
+    for (size_t field = 0; field < m_previous.size(); field++) {
+        float VariantBase::* member = m_ops.soa_fields[field];
+        float* previous = m_previous[field].data();
+
+        for (size_t slot = 0; slot < m_variants.size(); slot++) {
+            previous[slot] = m_variants[slot]->*member;
+        }
+    }
+}
+
+void VariantPool::interpolate(entity_id id, float alpha, VariantBase& out) const {
+    const uint32_t slot = find_slot(id);
+    if (slot == INVALID_SLOT) {
+        return;
+    }
+
+    for (size_t field = 0; field < m_previous.size(); field++) {
+        float VariantBase::* member = m_ops.soa_fields[field];
+        const float previous = m_previous[field][slot];
+
+        out.*member = previous + (m_variants[slot]->*member - previous) * alpha;
+    }
+}
+
+void VariantPool::reset_previous(entity_id id) {
+    const uint32_t slot = find_slot(id);
+    if (slot == INVALID_SLOT) {
+        return;
+    }
+
+    for (size_t field = 0; field < m_previous.size(); field++) {
+        m_previous[field][slot] = m_variants[slot]->*m_ops.soa_fields[field];
+    }
+}
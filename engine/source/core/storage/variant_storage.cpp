@@ -0,0 +1,236 @@
+#include "core/storage/variant_storage.h"
+
+#include <algorithm>
+
+#include "variant/variant_base.h"
+#include "remote_logger/remote_logger.h"
+
+VariantStorage::VariantStorage() {
+    m_pools.resize(VARIANT_TYPE_COUNT);
+    m_type_views.resize(VARIANT_TYPE_COUNT);
+    m_singletons.resize(VARIANT_TYPE_COUNT, nullptr);
+}
+
+VariantPool& VariantStorage::get_pool(variant_type_index index) {
+    auto& pool = m_pools[index];
+    if (!pool) {
+        pool = std::make_unique<VariantPool>(index, get_variant_rttr_type(index), get_variant_type_ops(index));
+    }
+
+    return *pool;
+}
+
+VariantPool* VariantStorage::prepare_add(entity_id id, variant_type_index index) {
+    if (!m_registry.is_alive(id)) {
+        log_error() << "Cannot add " << VARIANT_TYPE_NAMES[index] << ": entity " << id << " is not alive" << std::endl;
+        return nullptr;
+    }
+
+    VariantPool& pool = get_pool(index);
+
+    if (is_singleton_variant(index) && !pool.empty() && !pool.contains(id)) {
+        log_error() << "Cannot add " << VARIANT_TYPE_NAMES[index] << " to entity " << id << ": it is a singleton and already exists" << std::endl;
+        return nullptr;
+    }
+
+    if (!pool.contains(id)) {
+        m_entity_types[get_entity_index(id)].push_back(index);
+        m_entity_masks[get_entity_index(id)] |= variant_mask(1) << index;
+    }
+
+    return &pool;
+}
+
+VariantBase* VariantStorage::finish_add(entity_id id, variant_type_index index, VariantBase* stored) {
+    if (is_singleton_variant(index)) {
+        m_singletons[index] = stored;
+    }
+
+    for (VariantViewBase* view : m_type_views[index]) {
+        view->on_variant_added(*this, id);
+    }
+
+    return stored;
+}
+
+VariantBase* VariantStorage::add_variant(entity_id id, variant_type_index index, VariantBase& variant) {
+    VariantPool* pool = prepare_add(id, index);
+    if (!pool) {
+        return nullptr;
+    }
+
+    return finish_add(id, index, pool->insert(id, variant, m_tick));
+}
+
+VariantBase* VariantStorage::emplace_variant(entity_id id, variant_type_index index) {
+    VariantPool* pool = prepare_add(id, index);
+    if (!pool) {
+        return nullptr;
+    }
+
+    return finish_add(id, index, pool->emplace(id, m_tick));
+}
+
+VariantBase* VariantStorage::add_variant(entity_id id, variant_type_index index, rttr::variant&& variant) {
+    return add_variant(id, index, variant.get_value<VariantBase&>());
+}
+
+VariantBase* VariantStorage::add_variant(entity_id id, rttr::variant&& variant) {
+    const variant_type_index index = get_variant_type_index(variant.get_type());
+    if (index == INVALID_VARIANT_TYPE) {
+        log_error() << "Type " << variant.get_type().get_name() << " is not a registered variant" << std::endl;
+        return nullptr;
+    }
+
+    return add_variant(id, index, std::move(variant));
+}
+
+std::vector<VariantBase*> VariantStorage::get_variants(entity_id id) {
+    std::vector<VariantBase*> variants;
+
+    if (!m_registry.is_alive(id)) {
+        return variants;
+    }
+
+    const auto& indices = m_entity_types[get_entity_index(id)];
+    variants.reserve(indices.size());
+    for (variant_type_index index : indices) {
+        if (VariantBase* variant = find_variant(id, index)) {
+            variants.push_back(variant);
+        }
+    }
+
+    return variants;
+}
+
+entity_id VariantStorage::create_entity() {
+    const entity_id id = m_registry.create();
+    if (get_entity_index(id) >= m_entity_types.size()) {
+        m_entity_types.resize(get_entity_index(id) + 1);
+        m_entity_masks.resize(get_entity_index(id) + 1, 0);
+    }
+
+    return id;
+}
+
+entity_id VariantStorage::create_entity(entity_guid guid) {
+    const entity_id id = m_registry.create(guid);
+    if (get_entity_index(id) >= m_entity_types.size()) {
+        m_entity_types.resize(get_entity_index(id) + 1);
+        m_entity_masks.resize(get_entity_index(id) + 1, 0);
+    }
+
+    return id;
+}
+
+bool VariantStorage::create_reserved_entity(entity_id id) {
+    if (!m_registry.commit(id)) {
+        return false;
+    }
+
+    if (get_entity_index(id) >= m_entity_types.size()) {
+        m_entity_types.resize(get_entity_index(id) + 1);
+        m_entity_masks.resize(get_entity_index(id) + 1, 0);
+    }
+
+    return true;
+}
+
+std::vector<entity_id> VariantStorage::create_entities(size_t count) {
+    std::vector<entity_id> ids(count);
+    uint32_t last_index = 0;
+    for (size_t i = 0; i < count; i++) {
+        ids[i] = m_registry.create();
+        last_index = std::max(last_index, get_entity_index(ids[i]));
+    }
+
+    if (count > 0 && last_index >= m_entity_types.size()) {
+        m_entity_types.resize(last_index + 1);
+        m_entity_masks.resize(last_index + 1, 0);
+    }
+
+    return ids;
+}
+
+void VariantStorage::remove_variant(entity_id id, variant_type_index index) {
+    VariantPool* pool = find_pool(index);
+    if (!pool || !pool->contains(id)) {
+        return;
+    }
+
+    for (VariantViewBase* view : m_type_views[index]) {
+        view->on_variant_removed(id);
+    }
+
+    pool->erase(id);
+    if (is_singleton_variant(index)) {
+        m_singletons[index] = nullptr;
+    }
+
+    auto& indices = m_entity_types[get_entity_index(id)];
+    indices.erase(std::remove(indices.begin(), indices.end(), index), indices.end());
+    m_entity_masks[get_entity_index(id)] &= ~(variant_mask(1) << index);
+}
+
+void VariantStorage::remove_entity(entity_id id) {
+    if (!m_registry.is_alive(id)) {
+        return;
+    }
+
+    auto& indices = m_entity_types[get_entity_index(id)];
+    for (variant_type_index index : indices) {
+        for (VariantViewBase* view : m_type_views[index]) {
+            view->on_variant_removed(id);
+        }
+
+        if (VariantPool* pool = find_pool(index)) {
+            pool->erase(id);
+        }
+
+        if (is_singleton_variant(index)) {
+            m_singletons[index] = nullptr;
+        }
+    }
+
+    indices.clear();
+    m_entity_masks[get_entity_index(id)] = 0;
+    m_registry.destroy(id);
+}
+
+void VariantStorage::clear() {
+    for (auto& pool : m_pools) {
+        if (pool) {
+            pool->clear();
+        }
+    }
+
+    m_registry.clear();
+    std::fill(m_singletons.begin(), m_singletons.end(), nullptr);
+    for (auto& indices : m_entity_types) {
+        indices.clear();
+    }
+    std::fill(m_entity_masks.begin(), m_entity_masks.end(), 0);
+
+    for (auto& [key, view] : m_view_lookup) {
+        view->clear();
+    }
+}
+
+void VariantStorage::save_previous() {
+    for (auto& pool : m_pools) {
+        if (pool && pool->get_soa_field_count() > 0) {
+            pool->save_previous();
+        }
+    }
+}
+
+void VariantStorage::register_view(std::unique_ptr<VariantViewBase> view) {
+    view->build(*this);
+
+    for (variant_type_index index : view->get_type_indices()) {
+        m_type_views[index].push_back(view.get());
+    }
+
+    const std::type_index key = typeid(*view);
+    m_view_lookup.emplace(key, std::move(view));
+}
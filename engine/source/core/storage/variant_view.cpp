@@ -0,0 +1,81 @@
+#include "core/storage/variant_view.h"
+
+#include <algorithm>
+
+#include "core/storage/variant_storage.h"
+#include "variant/variant_base.h"
+
+void VariantViewBase::build(VariantStorage& storage) {
+    clear();
+
+    const VariantPool* smallest = nullptr;
+    for (variant_type_index index : m_indices) {
+        const VariantPool* pool = storage.find_pool(index);
+        if (!pool || pool->empty()) {
+            return;
+        }
+
+        if (!smallest || pool->size() < smallest->size()) {
+            smallest = pool;
+        }
+    }
+
+    if (!smallest) {
+        return;
+    }
+
+    for (entity_id id : smallest->get_entities()) {
+        on_variant_added(storage, id);
+    }
+}
+
+void VariantViewBase::on_variant_added(VariantStorage& storage, entity_id id) {
+    if (contains(id) || !storage.has_variants(id, m_mask)) {
+        return;
+    }
+
+    const size_t first = m_rows.size();
+    for (variant_type_index index : m_indices) {
+        VariantBase* variant = storage.find_variant(id, index);
+        if (!variant) {
+            m_rows.resize(first);
+            return;
+        }
+
+        m_rows.push_back(variant);
+    }
+
+    const uint32_t entity_index = get_entity_index(id);
+    if (entity_index >= m_sparse.size()) {
+        m_sparse.resize(entity_index + 1, INVALID_ROW);
+    }
+
+    m_sparse[entity_index] = static_cast<uint32_t>(m_entities.size());
+    m_entities.push_back(id);
+}
+
+void VariantViewBase::on_variant_removed(entity_id id) {
+    const uint32_t row = find_row(id);
+    if (row == INVALID_ROW) {
+        return;
+    }
+
+    const size_t stride = m_indices.size();
+    const size_t last = m_entities.size() - 1;
+
+    if (row != last) {
+        m_entities[row] = m_entities[last];
+        std::copy(m_rows.begin() + last * stride, m_rows.begin() + (last + 1) * stride, m_rows.begin() + row * stride);
+        m_sparse[get_entity_index(m_entities[row])] = row;
+    }
+
+    m_entities.pop_back();
+    m_rows.resize(last * stride);
+    m_sparse[get_entity_index(id)] = INVALID_ROW;
+}
+
+void VariantViewBase::clear() {
+    m_entities.clear();
+    m_rows.clear();
+    m_sparse.clear();
+}
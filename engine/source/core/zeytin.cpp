@@ -14,7 +14,6 @@
 
 #include "core/json/from_json.h"
 #include "core/json/to_json.h"
-#include "core/guid/guid.h"
 #include "core/raylib_wrapper.h"
 #include "core/utils.h"
 
@@ -30,6 +29,26 @@
 #include "config_manager/config_manager.h""
 
 Zeytin::Zeytin() {
+    CONSTRUCT_SINGLETON(JobSystem);
+    m_parallel_play_update = CONFIG_GET("parallel_play_update", bool, false);
+    m_fixed_delta = 1.0f / std::max(CONFIG_GET("tick_rate", int, 60), 1);
+    m_max_substeps = std::max(CONFIG_GET("max_substeps", int, 5), 1);
+
+    // comma separated variant names that update first, e.g. "Paddle,Ball,Collider"
+    std::vector<variant_type_index> update_order;
+    for (const std::string& name : split_list(CONFIG_GET("variant_update_order", std::string, ""))) {
+        const variant_type_index index = get_variant_type_index(rttr::type::get_by_name(name));
+        if (index == INVALID_VARIANT_TYPE) {
+            log_warning() << "variant_update_order: " << name << " is not a variant" << std::endl;
+            continue;
+        }
+
+        update_order.push_back(index);
+    }
+
+    set_variant_dispatch_order(update_order);
+    m_play_scheduler.build();
+
 #ifdef EDITOR_MODE
     m_editor_communication = std::make_unique<EditorCommunication>();
     subscribe_editor_events();
@@ -76,14 +95,33 @@ void Zeytin::run_frame() {
 
     post_init_variants();
     update_variants();
+    apply_commands();
 
     end_mode2d();
 
     if(m_is_play_mode && !m_is_pause_play_mode) {
+        const bool first_frame = !m_started;
+
         play_start_variants();
+        apply_commands();
         play_late_start_variants();
-        play_update_variants();
+        apply_commands();
+
+        if (first_frame) {
+            m_storage.save_previous();
+        }
+
+        run_fixed_steps(get_frame_time());
     }
+    else {
+        m_interpolation_alpha = 1.0f;
+    }
+
+    JobSystem::get().wait(m_frame_jobs);
+
+    apply_commands();
+    reclaim_dead_variants();
+    m_storage.advance_tick();
 
     end_texture_mode();
 
@@ -94,49 +132,107 @@ void Zeytin::run_frame() {
     end_drawing();
 }
 
+void Zeytin::run_fixed_steps(float frame_time) {
+    ZPROFILE_ZONE_NAMED("Zeytin::run_fixed_steps()");
+
+    // after a long frame only max_substeps steps are caught up, the rest of the
+    // time is dropped so a slow frame cannot make the next one slower
+    m_accumulator = std::min(m_accumulator + frame_time, m_fixed_delta * m_max_substeps);
+
+    while (m_accumulator >= m_fixed_delta) {
+        m_storage.save_previous();
+
+        play_update_variants();
+        JobSystem::get().wait(m_frame_jobs);
+
+        {
+            ZPROFILE_ZONE_NAMED("Zeytin::integrate_variants()");
+            m_integrator.run(m_storage, m_fixed_delta);
+        }
+
+        apply_commands();
+        m_accumulator -= m_fixed_delta;
+    }
+
+    m_interpolation_alpha = m_accumulator / m_fixed_delta;
+}
+
+void Zeytin::apply_commands() {
+    ZPROFILE_ZONE_NAMED("Zeytin::apply_commands()");
+    m_commands.apply();
+}
+
 entity_id Zeytin::new_entity_id() {
-    return generate_unique_id();
+    return m_storage.create_entity();
 }
 
-std::vector<rttr::variant>& Zeytin::get_variants(const entity_id& entity) {
-    return m_storage[entity];
+std::vector<VariantBase*> Zeytin::get_variants(const entity_id& entity) {
+    return m_storage.get_variants(entity);
 }
 
-void Zeytin::clean_dead_variants() {
-    for(auto& [entity_id, variants] : m_storage) {
-        variants.erase(
-            std::remove_if(variants.begin(), variants.end(),
-                [](rttr::variant& variant) {
-                    VariantBase& var_base = variant.get_value<VariantBase&>();
-                    return var_base.is_dead;
-                }
-            ),
-            variants.end()
-        );
+void Zeytin::reclaim_dead_variants() {
+    ZPROFILE_ZONE_NAMED("Zeytin::reclaim_dead_variants()");
+
+    if (m_dead_variants.empty() && m_dead_entities.empty()) return;
+
+    std::vector<bool> touched(VARIANT_TYPE_COUNT, false);
+
+    for (const auto& [id, index] : m_dead_variants) {
+        // the variant may have been replaced or its entity destroyed since it was marked
+        VariantBase* variant = m_storage.find_variant(id, index);
+        if (variant && variant->is_dead) {
+            m_storage.remove_variant(id, index);
+            touched[index] = true;
+        }
+    }
+
+    for (entity_id id : m_dead_entities) {
+        for (VariantBase* variant : m_storage.get_variants(id)) {
+            touched[get_variant_type_index(rttr::type::get(*variant))] = true;
+        }
+
+        m_storage.remove_entity(id);
+    }
+
+    m_dead_variants.clear();
+    m_dead_entities.clear();
+
+    for (variant_type_index index = 0; index < VARIANT_TYPE_COUNT; index++) {
+        if (touched[index]) {
+            m_storage.get_pool(index).compact();
+        }
     }
 }
 
 std::string Zeytin::zserialize_entity(const entity_id id) {
-    return rttr_json::serialize_entity(id, get_variants(id));
+    return rttr_json::serialize_entity(m_storage.get_guid(id), get_variants(id));
 }
 
 std::string Zeytin::zserialize_entity(const entity_id id, const std::filesystem::path& path) {
-    return rttr_json::serialize_entity(id, get_variants(id), path);
+    return rttr_json::serialize_entity(m_storage.get_guid(id), get_variants(id), path);
 }
 
 entity_id Zeytin::zdeserialize_entity(const std::string& str) {
-    entity_id id;
+    entity_guid guid;
     std::vector<rttr::variant> variants;
 
-    rttr_json::deserialize_entity(str, id, variants);
+    rttr_json::deserialize_entity(str, guid, variants);
 
-    auto& entity_variants = get_variants(id);
-    entity_variants.clear();
+    m_storage.remove_entity(m_storage.find_entity(guid));
+    entity_id id = m_storage.create_entity(guid);
 
     for (auto& var : variants) {
-        VariantBase& base = var.get_value<VariantBase&>();
-        base.on_init();
-        entity_variants.push_back(std::move(var));
+        var.get_value<VariantBase&>().entity_id = id;
+
+        if (m_storage.has_variant(id, var.get_type())) {
+            log_warning() << "Skipping duplicate variant " << var.get_type().get_name() << " on entity " << id << std::endl;
+            continue;
+        }
+
+        VariantBase* stored = m_storage.add_variant(id, std::move(var));
+        if (!stored) continue;
+
+        stored->on_init();
     }        
     return id;
 }
@@ -148,8 +244,11 @@ std::string Zeytin::serialize_scene() {
     rapidjson::Document::AllocatorType& allocator = document.GetAllocator();
     rapidjson::Value entitiesArray(rapidjson::kArrayType);
 
-    for (const auto& [entity_id, variants] : m_storage) {
-        std::string entityJson = zserialize_entity(entity_id);
+    std::vector<entity_id> entities;
+    m_storage.get_registry().each([&entities](entity_id id) { entities.push_back(id); });
+
+    for (entity_id id : entities) {
+        std::string entityJson = zserialize_entity(id);
 
         rapidjson::Document entityDoc;
         entityDoc.Parse(entityJson.c_str());
@@ -196,6 +295,9 @@ void Zeytin::load_scene(const std::filesystem::path& path) {
 
 bool Zeytin::deserialize_scene(const std::string& scene) {
     m_storage.clear();
+    m_commands.clear();
+    m_dead_variants.clear();
+    m_dead_entities.clear();
 
     rapidjson::Document scene_data;
     rapidjson::ParseResult parse_result = scene_data.Parse(scene.c_str());
@@ -226,19 +328,45 @@ bool Zeytin::deserialize_scene(const std::string& scene) {
     return true;
 }
 
+void Zeytin::remove_variant(entity_id id, variant_type_index index) {
+    if(VariantBase* variant = m_storage.find_variant(id, index)) {
+        if(variant->is_dead) return;
+
+        variant->is_dead = true;
+        m_dead_variants.emplace_back(id, index);
+    }
+}
+
+void Zeytin::remove_variant(entity_id id, const rttr::type& type) {
+    remove_variant(id, get_variant_type_index(type));
+}
+
+void Zeytin::remove_entity(entity_id id) {
+    if(!m_storage.has_entity(id)) return;
+
+    for (VariantBase* variant : m_storage.get_variants(id)) {
+        variant->is_dead = true;
+    }
+
+    m_dead_entities.push_back(id);
+}
+
 void Zeytin::post_init_variants() {
     ZPROFILE_ZONE_NAMED("Zeytin::post_init_variants()");
 
-    for (auto& pair : m_storage) {   
-        for (auto& variant : pair.second) {
-            VariantBase& base = variant.get_value<VariantBase&>();
+    for (variant_type_index index : get_hooked_variant_types(VARIANT_HOOK_POST_INIT)) {
+        VariantPool* pool = m_storage.find_pool(index);
+        if (!pool) continue;
+
+        for (size_t i = 0; i < pool->size(); i++) {
+            VariantBase& base = *pool->get_variants()[i];
             if(base.is_dead || base.post_inited) continue;
             base.post_inited = true;
             {
                 ZPROFILE_ZONE_NAMED("VariantBase::post_init_variants()");
                 ZPROFILE_TEXT(base.get_type().get_name().to_string().c_str(),
                             base.get_type().get_name().to_string().size());
-                ZPROFILE_VALUE(pair.first);
+                ZPROFILE_VALUE(base.entity_id);
                 base.on_post_init();
             }
         }
@@ -248,14 +376,17 @@ void Zeytin::post_init_variants() {
 void Zeytin::update_variants() {
     ZPROFILE_ZONE_NAMED("Zeytin::update_variants()");
 
-    for (auto& pair : m_storage) {   
-        for (auto& variant : pair.second) {
-            VariantBase& base = variant.get_value<VariantBase&>();
+    for (variant_type_index index : get_hooked_variant_types(VARIANT_HOOK_UPDATE)) {
+        VariantPool* pool = m_storage.find_pool(index);
+        if (!pool) continue;
+
+        for (size_t i = 0; i < pool->size(); i++) {
+            VariantBase& base = *pool->get_variants()[i];
             if(base.is_dead) continue;
             {
                 ZPROFILE_ZONE_NAMED("VariantBase::on_update()");
                 ZPROFILE_TEXT(base.get_type().get_name().to_string().c_str(),base.get_type().get_name().to_string().size());
-                ZPROFILE_VALUE(pair.first);
+                ZPROFILE_VALUE(base.entity_id);
 
                 base.on_update();
             }
@@ -266,16 +397,28 @@ void Zeytin::update_variants() {
 void Zeytin::play_update_variants() {
     ZPROFILE_ZONE_NAMED("Zeytin::play_update_variants()");
 
-    for (auto& pair : m_storage) {   
-        for (auto& variant : pair.second) {
-            VariantBase& base = variant.get_value<VariantBase&>();
-            if(base.is_dead) continue;
-            {
-                ZPROFILE_ZONE_NAMED("VariantBase::on_play_update()");
-                ZPROFILE_TEXT(base.get_type().get_name().to_string().c_str(),base.get_type().get_name().to_string().size());
-                ZPROFILE_VALUE(pair.first);
-                base.on_play_update();
-            }
+    if (m_parallel_play_update) {
+        m_play_scheduler.run([this](variant_type_index index) { play_update_pool(index); });
+        return;
+    }
+
+    for (variant_type_index index : get_hooked_variant_types(VARIANT_HOOK_PLAY_UPDATE)) {
+        play_update_pool(index);
+    }
+}
+
+void Zeytin::play_update_pool(variant_type_index index) {
+    VariantPool* pool = m_storage.find_pool(index);
+    if (!pool) return;
+
+    for (size_t i = 0; i < pool->size(); i++) {
+        VariantBase& base = *pool->get_variants()[i];
+        if(base.is_dead) continue;
+        {
+            ZPROFILE_ZONE_NAMED("VariantBase::on_play_update()");
+            ZPROFILE_TEXT(base.get_type().get_name().to_string().c_str(),base.get_type().get_name().to_string().size());
+            ZPROFILE_VALUE(base.entity_id);
+            base.on_play_update();
         }
     }
 }
@@ -286,14 +429,17 @@ void Zeytin::play_start_variants() {
     if (m_started) return;
     m_started = true;
 
-    for (auto& pair : m_storage) {   
-        for (auto& variant : pair.second) {
-            VariantBase& base = variant.get_value<VariantBase&>();
+    for (variant_type_index index : get_hooked_variant_types(VARIANT_HOOK_PLAY_START)) {
+        VariantPool* pool = m_storage.find_pool(index);
+        if (!pool) continue;
+
+        for (size_t i = 0; i < pool->size(); i++) {
+            VariantBase& base = *pool->get_variants()[i];
             if(base.is_dead) continue;
             {
                 ZPROFILE_ZONE_NAMED("VariantBase::on_play_update()");
                 ZPROFILE_TEXT(base.get_type().get_name().to_string().c_str(),base.get_type().get_name().to_string().size());
-                ZPROFILE_VALUE(pair.first);
+                ZPROFILE_VALUE(base.entity_id);
                 base.on_play_start();
             }
         }
@@ -306,14 +452,17 @@ void Zeytin::play_late_start_variants() {
     if (m_late_started) return;
     m_late_started = true;
 
-    for (auto& pair : m_storage) {   
-        for (auto& variant : pair.second) {
-            VariantBase& base = variant.get_value<VariantBase&>();
+    for (variant_type_index index : get_hooked_variant_types(VARIANT_HOOK_PLAY_LATE_START)) {
+        VariantPool* pool = m_storage.find_pool(index);
+        if (!pool) continue;
+
+        for (size_t i = 0; i < pool->size(); i++) {
+            VariantBase& base = *pool->get_variants()[i];
             if(base.is_dead) continue;
             {
                 ZPROFILE_ZONE_NAMED("VariantBase::on_play_late_start()");
                 ZPROFILE_TEXT(base.get_type().get_name().to_string().c_str(),base.get_type().get_name().to_string().size());
-                ZPROFILE_VALUE(pair.first);
+                ZPROFILE_VALUE(base.entity_id);
                 base.on_play_late_start();
             }
         }
@@ -378,7 +527,7 @@ void Zeytin::subscribe_editor_events() {
     EditorEventBus::get().subscribe<bool>(
         EditorEvent::EnterPlayMode, 
         [this](bool is_paused) {
-            clean_dead_variants();
+            reclaim_dead_variants();
             enter_play_mode(is_paused);
         }
     );
@@ -420,19 +569,19 @@ void Zeytin::handle_entity_property_changed(const rapidjson::Document& doc) {
     assert(doc.HasMember("key_path"));
     assert(doc.HasMember("value"));
 
-    uint64_t entity_id = doc["entity_id"].GetUint64();
+    entity_id entity_id = m_storage.find_entity(doc["entity_id"].GetUint64());
     const std::string& variant_type = doc["variant_type"].GetString();
     const std::string& key_type = doc["key_type"].GetString();
     const std::string& key_path = doc["key_path"].GetString();
     const std::string& value_str = doc["value"].GetString();
 
-    if (m_storage.find(entity_id) == m_storage.end()) {
-        log_error() << "Entity " << entity_id << " not found" << std::endl;
+    if (!m_storage.has_entity(entity_id)) {
+        log_error() << "Entity " << doc["entity_id"].GetUint64() << " not found" << std::endl;
         return;
     }
 
-    for (auto& variant : m_storage[entity_id]) {
-        if (variant.get_type().get_name() == variant_type) {
+    for (VariantBase* variant : m_storage.get_variants(entity_id)) {
+        if (rttr::type::get(*variant).get_name() == variant_type) {
             std::vector<std::string> path_parts = split_path(key_path);
 
             if (path_parts.empty()) {
@@ -441,16 +590,16 @@ void Zeytin::handle_entity_property_changed(const rapidjson::Document& doc) {
             }
 
             if (key_type == "int") {
-                update_property(variant, path_parts, 0, std::stoi(value_str));
+                update_property(*variant, path_parts, 0, std::stoi(value_str));
             }
             else if (key_type == "float") {
-                update_property(variant, path_parts, 0, std::stof(value_str));
+                update_property(*variant, path_parts, 0, std::stof(value_str));
             }
             else if (key_type == "bool") {
-                update_property(variant, path_parts, 0, (value_str == "true" || value_str == "1"));
+                update_property(*variant, path_parts, 0, (value_str == "true" || value_str == "1"));
             }
             else if (key_type == "string") {
-                update_property(variant, path_parts, 0, value_str);
+                update_property(*variant, path_parts, 0, value_str);
             }
 
             break; 
@@ -463,8 +612,11 @@ void Zeytin::handle_entity_variant_added(const rapidjson::Document& msg) {
     assert(msg.HasMember("entity_id"));
     assert(msg.HasMember("variant_type"));
 
-    entity_id entity_id = msg["entity_id"].GetUint64();
-    auto& variants = m_storage[entity_id];
+    const entity_guid guid = msg["entity_id"].GetUint64();
+    entity_id entity_id = m_storage.find_entity(guid);
+    if (entity_id == INVALID_ENTITY) {
+        entity_id = m_storage.create_entity(guid);
+    }
 
     VariantCreateInfo info;
     info.entity_id = entity_id;
@@ -478,9 +630,18 @@ void Zeytin::handle_entity_variant_added(const rapidjson::Document& msg) {
         return;
     }
 
+    if(VariantBase* existing = m_storage.find_variant(entity_id, rttr_type)) {
+        if(!existing->is_dead) {
+            log_warning() << "Entity " << entity_id << " already has variant " << rttr_type.get_name() << std::endl;
+            return;
+        }
+
+        m_storage.remove_variant(entity_id, rttr_type);
+    }
+
     rttr::variant obj = rttr_type.create(args);
 
-    variants.push_back(std::move(obj));
+    m_storage.add_variant(entity_id, std::move(obj));
 }
 
 void Zeytin::handle_entity_variant_removed(const rapidjson::Document& msg) {
@@ -488,8 +649,7 @@ void Zeytin::handle_entity_variant_removed(const rapidjson::Document& msg) {
     assert(msg.HasMember("entity_id"));
     assert(msg.HasMember("variant_type"));
 
-    entity_id entity_id = msg["entity_id"].GetUint64();
-    auto& variants = m_storage[entity_id];
+    entity_id entity_id = m_storage.find_entity(msg["entity_id"].GetUint64());
     rttr::type rttr_type = rttr::type::get_by_name(msg["variant_type"].GetString());
 
     if(!rttr_type.is_valid()) {
@@ -500,27 +660,11 @@ void Zeytin::handle_entity_variant_removed(const rapidjson::Document& msg) {
     remove_variant(entity_id, rttr_type);
 }
 
-void Zeytin::remove_variant(entity_id id, const rttr::type& type) {
-    for(auto& variant : get_variants(id)) {
-        if(variant.get_type() == type) {
-            VariantBase& base = variant.get_value<VariantBase&>();
-            base.is_dead = true;
-        }
-    }
-}
-
-void Zeytin::remove_entity(entity_id id) {
-    m_storage[id].clear();
-}
-
-
 void Zeytin::handle_entity_removed(const rapidjson::Document& msg) {
     assert(!msg.HasParseError());
     assert(msg.HasMember("entity_id"));
 
-    entity_id entity_id = msg["entity_id"].GetUint64();
-
-    remove_entity(entity_id);
+    remove_entity(m_storage.find_entity(msg["entity_id"].GetUint64()));
 }
 
 
@@ -540,7 +684,11 @@ void Zeytin::enter_play_mode(bool is_paused) {
 
 void Zeytin::exit_play_mode() {
     m_storage.clear();
+    m_commands.clear();
+    m_dead_variants.clear();
+    m_dead_entities.clear();
     m_started = false;
+    m_accumulator = 0.0f;
     m_is_play_mode = false;
 
     if (std::filesystem::exists("temp/backup.scene")) {
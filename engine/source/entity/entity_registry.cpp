@@ -0,0 +1,114 @@
+#include "entity/entity_registry.h"
+
+#include "core/guid/guid.h"
+
+entity_id EntityRegistry::create() {
+    uint32_t index;
+    if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+    } else {
+        index = m_next_index.fetch_add(1, std::memory_order_relaxed);
+        if (index >= m_slots.size()) {
+            m_slots.resize(index + 1);
+        }
+    }
+
+    Slot& slot = m_slots[index];
+    slot.alive = true;
+    slot.has_guid = false;
+
+    return make_entity_id(index, slot.generation);
+}
+
+entity_id EntityRegistry::create(entity_guid guid) {
+    const entity_id id = create();
+
+    Slot& slot = m_slots[get_entity_index(id)];
+    slot.has_guid = true;
+    slot.guid = guid;
+    m_guids[guid] = id;
+
+    return id;
+}
+
+entity_id EntityRegistry::reserve() {
+    // slots nobody has used yet start at generation 0
+    return make_entity_id(m_next_index.fetch_add(1, std::memory_order_relaxed), 0);
+}
+
+bool EntityRegistry::commit(entity_id id) {
+    const uint32_t index = get_entity_index(id);
+    if (index < m_first_reservation) {
+        return false;
+    }
+
+    if (index >= m_slots.size()) {
+        m_slots.resize(index + 1);
+    }
+
+    Slot& slot = m_slots[index];
+    slot.alive = true;
+    slot.has_guid = false;
+    return true;
+}
+
+void EntityRegistry::destroy(entity_id id) {
+    if (!is_alive(id)) {
+        return;
+    }
+
+    const uint32_t index = get_entity_index(id);
+    Slot& slot = m_slots[index];
+
+    if (slot.has_guid) {
+        m_guids.erase(slot.guid);
+    }
+
+    slot.alive = false;
+    slot.has_guid = false;
+    slot.generation++;
+    m_free.push_back(index);
+}
+
+void EntityRegistry::clear() {
+    // slots are kept and their generations bumped, so handles from before the clear stay stale
+    m_free.clear();
+    for (uint32_t index = static_cast<uint32_t>(m_slots.size()); index-- > 0;) {
+        Slot& slot = m_slots[index];
+        if (slot.alive) {
+            slot.generation++;
+        }
+
+        slot.alive = false;
+        slot.has_guid = false;
+        m_free.push_back(index);
+    }
+
+    m_guids.clear();
+    m_first_reservation = m_next_index.load(std::memory_order_relaxed);
+}
+
+entity_guid EntityRegistry::get_guid(entity_id id) {
+    if (!is_alive(id)) {
+        return 0;
+    }
+
+    Slot& slot = m_slots[get_entity_index(id)];
+    if (!slot.has_guid) {
+        slot.guid = generate_unique_id();
+        while (m_guids.find(slot.guid) != m_guids.end()) {
+            slot.guid = generate_unique_id();
+        }
+
+        slot.has_guid = true;
+        m_guids[slot.guid] = id;
+    }
+
+    return slot.guid;
+}
+
+entity_id EntityRegistry::find(entity_guid guid) const {
+    auto it = m_guids.find(guid);
+    return it != m_guids.end() ? it->second : INVALID_ENTITY;
+}
@@ -10,23 +10,43 @@
 #include "game/game.h"
 
 void Ball::on_update() {
-    auto& collider = Query::get<Collider>(this);
-    draw_circle_v(collider.get_circle_center(), collider.get_radius(), GREEN);
+    const auto& collider = Query::read<Collider>(this);
+    const auto position = Query::interpolated<Position>(this);
+    draw_circle_v(Vector2{ position.x, position.y }, collider.get_radius(), GREEN);
 }
 
 void Ball::on_play_start() {
+    // waits on the paddle until the game starts
+    stop();
+
+    // the collider and Game can outlive this ball, so the callbacks resolve it first
+    auto self = Query::handle(*this);
+
     auto& collider = Query::get<Collider>(this);
-    collider.m_callback = [this](Collider& other) {
-        handle_collision(other);
+    collider.m_on_collision_enter = [self](Collider& other) {
+        if (Ball* ball = self.resolve()) {
+            ball->handle_collision(other);
+        }
+    };
+
+    // still overlapping after the push-out, e.g. squeezed against the paddle
+    collider.m_on_collision_stay = [self](Collider& other) {
+        if (Ball* ball = self.resolve()) {
+            ball->bounce(other);
+        }
     };
 
     auto& game = Query::find_first<Game>();
-    game.register_on_game_start([this]() {
-        launch();
+    game.register_on_game_start([self]() {
+        if (Ball* ball = self.resolve()) {
+            ball->launch();
+        }
     });
 
-    game.register_on_game_end([this](){
-        m_launched = false;
+    game.register_on_game_end([self](){
+        if (Ball* ball = self.resolve()) {
+            ball->stop();
+        }
     });
 }
 
@@ -47,11 +67,8 @@ void Ball::on_play_update() {
         
         return;
     }
-    
-    float delta_time = get_frame_time();
 
-    position.x += velocity.x * delta_time;
-    position.y += velocity.y * delta_time;
+    // moving along velocity is done by the engine, see INTEGRATE_INTO in velocity.h
 }
 
 void Ball::launch() {
@@ -63,16 +80,39 @@ void Ball::launch() {
     velocity.y = speed.value;
 }
 
+void Ball::stop() {
+    m_launched = false;
+
+    auto& velocity = Query::get<Velocity>(this);
+    velocity.x = 0;
+    velocity.y = 0;
+}
+
 void Ball::reset_position(float x, float y) {
     auto& position = Query::get<Position>(this);
     position.x = x;
     position.y = y;
-    m_launched = false;
+    stop();
 }
 
 void Ball::handle_collision(Collider& other) {
+    bounce(other);
+
+    if(Query::has<Brick>(other.entity_id)) {
+        auto& brick = Query::get<Brick>(other.entity_id);
+        brick.damage();
+    }
+
+    if(Query::has<Tag>(other.entity_id)) {
+        const auto& tag = Query::read<Tag>(other.entity_id);
+        if(tag.value == "bottom") {
+            Query::find_first<Game>().end_game();
+        }
+    }
+}
+
+void Ball::bounce(Collider& other) {
     auto [velocity, position, collider] = Query::get<Velocity, Position, Collider>(this);
-    auto& other_position = Query::get<Position>(other.entity_id);
 
     if(other.m_collider_type == 1) { // Rectangle
         Rectangle rect = other.get_rectangle();
@@ -136,17 +176,4 @@ void Ball::handle_collision(Collider& other) {
             velocity.y = velocity.y - 2 * dot_product * normal.y;
         }
     }
-
-    if(Query::has<Brick>(other.entity_id)) {
-        auto& brick = Query::get<Brick>(other.entity_id);
-        brick.damage();
-    }
-
-
-    if(Query::has<Tag>(other.entity_id)) {
-        const auto& tag = Query::read<Tag>(other.entity_id);
-        if(tag.value == "bottom") {
-            Query::find_first<Game>().end_game();
-        }
-    }
 }
@@ -3,8 +3,9 @@
 #include "core/raylib_wrapper.h"
 #include "game/game.h"
 
-void Brick::on_play_update() {
-    if(is_destroyed()) {
+void Brick::on_update() {
+    // drawn once per frame rather than per fixed step, but still only while playing
+    if(is_destroyed() || !Zeytin::get().is_play_mode()) {
         return;
     }
 
@@ -8,8 +8,12 @@ void BrickManager::on_play_start() {
     auto result = Query::try_find_first<Game>();
     if(result) {
         auto& game = result->get();
-        game.register_on_game_end([this] {
-            Query::for_each<Brick>([this](Brick& brick){
+        game.register_on_game_end([self = Query::handle(*this)] {
+            if (!self) {
+                return;
+            }
+
+            Query::for_each<Brick>([](Brick& brick){
                 // rebuild it, just the way it was, brick by brick
                 brick.reset();
             });
@@ -18,26 +22,28 @@ void BrickManager::on_play_start() {
 }
 
 void BrickManager::create_bricks() {
-    for (int row = 0; row < rows; row++) {
-        for (int col = 0; col < columns; col++) {
-            float x = start_x + col * (brick_width + padding_x);
-            float y = start_y + row * (brick_height + padding_y);
-            
-            create_brick(x, y, row, col);
-        }
+    if (rows <= 0 || columns <= 0) {
+        return;
     }
-}
 
-void BrickManager::create_brick(float x, float y, int row, int col) {
-    auto entity = Query::create_entity();
-    
-    Query::add<Position>(entity, x, y);
-    auto& brick = Query::add<Brick>(entity, row % 3 + 1, get_brick_color(row))->get();
+    // runs from on_play_start, while the pools are being walked, so the bricks
+    // are recorded and show up at the next sync point
+    Query::commands().spawn_batch<Position, Brick, Collider>(rows * columns, [this](size_t i, auto, Position& position, Brick& brick, Collider& collider) {
+        const int row = static_cast<int>(i) / columns;
+        const int col = static_cast<int>(i) % columns;
+
+        position.x = start_x + col * (brick_width + padding_x);
+        position.y = start_y + row * (brick_height + padding_y);
+
+        brick.set_health(row % 3 + 1);
+        brick.set_color(get_brick_color(row));
 
-    auto& collider = Query::add<Collider>(entity)->get();
-    collider.m_collider_type = 1; 
-    collider.m_width = brick_width;
-    collider.m_height = brick_height;
+        collider.m_collider_type = 1;
+        collider.m_width = brick_width;
+        collider.m_height = brick_height;
+        // bricks never move, destroyed ones are only disabled
+        collider.m_static = true;
+    });
 }
 
 Color BrickManager::get_brick_color(int row) const {
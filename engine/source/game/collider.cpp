@@ -4,70 +4,39 @@
 #include "core/query.h"
 #include "raymath.h"
 
-enum class ColliderType : int {
-    None = 0,
-    Rectangle = 1,
-    Circle = 2,
-};
-
 void Collider::on_update() {
     debug_draw();
 }
 
-void Collider::on_play_update() {
-    check_collisions();
-}
-
-void Collider::check_collisions() {
-    auto& position = Query::read<Position>(this);
-
-    Query::for_each<Collider>([this](Collider& other) {
-        if(!m_enable || !other.m_enable) {
-            return;
-        }
-
-        if (other.entity_id == entity_id) {
-            return;
-        }
-
-        if (other.m_collider_type == (int)ColliderType::None) {
-            return;
-        }
-
-        if (this->intersects(other)) {
-            if(m_callback) {
-                m_callback(other);
-            }
-        }
-    });
+bool Collider::intersects(const Collider& other) const {
+    return intersects(other, Query::read<Position>(this), Query::read<Position>(other.entity_id));
 }
 
-bool Collider::intersects(const Collider& other) const {
-    if (m_collider_type == 0 || other.m_collider_type == 0) {
+bool Collider::intersects(const Collider& other, const Position& position, const Position& other_position) const {
+    if (m_collider_type == (int)ColliderType::None || other.m_collider_type == (int)ColliderType::None) {
         return false;
     }
 
-    if (m_collider_type == 1 && other.m_collider_type == 1) {
-        const auto& this_rect = get_rectangle();
-        const auto& other_rect = other.get_rectangle();
-        return CheckCollisionRecs(this_rect, other_rect);
+    if (m_collider_type == (int)ColliderType::Rectangle && other.m_collider_type == (int)ColliderType::Rectangle) {
+        return CheckCollisionRecs(get_rectangle(position), other.get_rectangle(other_position));
     }
 
-    if (m_collider_type == 2 && other.m_collider_type == 2) {
-        Vector2 center1 = get_circle_center();
-        Vector2 center2 = other.get_circle_center();
+    if (m_collider_type == (int)ColliderType::Circle && other.m_collider_type == (int)ColliderType::Circle) {
+        Vector2 center1 = get_circle_center(position);
+        Vector2 center2 = other.get_circle_center(other_position);
         float distance = Vector2Distance(center1, center2);
         return distance <= (m_radius + other.m_radius);
     }
 
-    if ((m_collider_type == 1 && other.m_collider_type == 2) ||
-        (m_collider_type == 2 && other.m_collider_type == 1)) {
+    if ((m_collider_type == (int)ColliderType::Rectangle && other.m_collider_type == (int)ColliderType::Circle) ||
+        (m_collider_type == (int)ColliderType::Circle && other.m_collider_type == (int)ColliderType::Rectangle)) {
 
-        const Collider& rect_collider = (m_collider_type == 1) ? *this : other;
-        const Collider& circle_collider = (m_collider_type == 2) ? *this : other;
+        const bool this_is_rect = m_collider_type == (int)ColliderType::Rectangle;
+        const Collider& rect_collider = this_is_rect ? *this : other;
+        const Collider& circle_collider = this_is_rect ? other : *this;
 
-        Rectangle rect = rect_collider.get_rectangle();
-        Vector2 center = circle_collider.get_circle_center();
+        Rectangle rect = rect_collider.get_rectangle(this_is_rect ? position : other_position);
+        Vector2 center = circle_collider.get_circle_center(this_is_rect ? other_position : position);
         float radius = circle_collider.m_radius;
 
         float closest_x = fmaxf(rect.x, fminf(center.x, rect.x + rect.width));
@@ -82,8 +51,10 @@ bool Collider::intersects(const Collider& other) const {
 }
 
 Rectangle Collider::get_rectangle() const {
-    const auto& position = Query::get<Position>(this);
+    return get_rectangle(Query::read<Position>(this));
+}
 
+Rectangle Collider::get_rectangle(const Position& position) const {
     return Rectangle{
         position.x - m_width / 2, 
         position.y - m_height / 2,
@@ -93,20 +64,36 @@ Rectangle Collider::get_rectangle() const {
 }
 
 Vector2 Collider::get_circle_center() const {
-    const auto& position = Query::get<Position>(this);
+    return get_circle_center(Query::read<Position>(this));
+}
 
+Vector2 Collider::get_circle_center(const Position& position) const {
     return Vector2{
         position.x,
         position.y
     };
 }
 
+Aabb Collider::get_bounds(const Position& position) const {
+    if (m_collider_type == (int)ColliderType::Circle) {
+        return Aabb{
+            { position.x - m_radius, position.y - m_radius },
+            { position.x + m_radius, position.y + m_radius }
+        };
+    }
+
+    return Aabb{
+        { position.x - m_width / 2, position.y - m_height / 2 },
+        { position.x + m_width / 2, position.y + m_height / 2 }
+    };
+}
+
 void Collider::debug_draw() {
     if (!m_draw_debug) {
         return;
     }
 
-    const auto& position = Query::get<Position>(this);
+    const auto& position = Query::read<Position>(this);
     Color color = m_is_trigger ? YELLOW : BLUE;
 
     switch (m_collider_type) {
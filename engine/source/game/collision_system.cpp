@@ -0,0 +1,262 @@
+#include "game/collision_system.h"
+#include "game/velocity.h"
+
+#include "core/query.h"
+#include "raymath.h"
+
+#include <cmath>
+
+namespace {
+    // swept bodies stop this far into what they hit, so the discrete test sees the contact
+    constexpr float LINEAR_SLOP = 0.01f;
+    // per swept body and step, counting the first one
+    constexpr int MAX_IMPACTS = 4;
+}
+
+void CollisionSystem::on_play_update() {
+    gather_colliders();
+    resolve_impacts();
+    find_contacts();
+    dispatch_contacts();
+    finish_impacts();
+}
+
+void CollisionSystem::gather_colliders() {
+    m_broad_phase.set_type(static_cast<BroadPhaseType>(broadphase));
+    m_broad_phase.set_cell_size(cell_size);
+    m_broad_phase.set_margin(tree_margin);
+    m_broad_phase.begin_step();
+
+    m_colliders.clear();
+    m_positions.clear();
+    m_motions.clear();
+    m_swept.clear();
+
+    Query::view<Collider, Position>().each([this](Collider& collider, Position& position) {
+        if (collider.is_dead || !collider.is_enable() || collider.m_collider_type == (int)ColliderType::None) {
+            return;
+        }
+
+        const uint32_t body = static_cast<uint32_t>(m_colliders.size());
+        Aabb bounds = collider.get_bounds(position);
+
+        const Vector2 motion = get_motion(collider);
+        if (motion.x != 0.0f || motion.y != 0.0f) {
+            const Aabb moved = { Vector2Add(bounds.min, motion), Vector2Add(bounds.max, motion) };
+            bounds = combine(bounds, moved);
+            m_swept.push_back(body);
+        }
+
+        m_broad_phase.update(body, collider.entity_id, bounds, collider.m_static);
+        m_colliders.push_back(&collider);
+        m_positions.push_back(&position);
+        m_motions.push_back(motion);
+    });
+
+    m_pairs.clear();
+    m_broad_phase.find_pairs(m_pairs);
+}
+
+Vector2 CollisionSystem::get_motion(const Collider& collider) const {
+    if (!collider.m_ccd || collider.m_collider_type != (int)ColliderType::Circle || !Query::has<Velocity>(collider.entity_id)) {
+        return Vector2{ 0.0f, 0.0f };
+    }
+
+    const auto& velocity = Query::read<Velocity>(collider.entity_id);
+    const Vector2 motion = Vector2Scale(Vector2{ velocity.x, velocity.y }, Query::delta_time());
+
+    // moving less than its radius per step it cannot skip over anything
+    if (Vector2LengthSqr(motion) <= collider.get_radius() * collider.get_radius()) {
+        return Vector2{ 0.0f, 0.0f };
+    }
+
+    return motion;
+}
+
+void CollisionSystem::resolve_impacts() {
+    m_impacts.clear();
+    if (m_swept.empty()) {
+        return;
+    }
+
+    m_times.assign(m_colliders.size(), 1.0f);
+
+    for (const ProxyPair& pair : m_pairs) {
+        const bool a_swept = m_motions[pair.a].x != 0.0f || m_motions[pair.a].y != 0.0f;
+        const bool b_swept = m_motions[pair.b].x != 0.0f || m_motions[pair.b].y != 0.0f;
+        if (!a_swept && !b_swept) {
+            continue;
+        }
+
+        // sweep a circle against the other one held still, by their relative motion
+        const uint32_t mover = a_swept ? pair.a : pair.b;
+        const uint32_t target = a_swept ? pair.b : pair.a;
+
+        const float time = time_of_impact(mover, target, Vector2Subtract(m_motions[mover], m_motions[target]));
+        if (time < 0.0f) {
+            continue;
+        }
+
+        m_times[pair.a] = std::fmin(m_times[pair.a], time);
+        m_times[pair.b] = std::fmin(m_times[pair.b], time);
+    }
+
+    for (uint32_t body : m_swept) {
+        const float time = m_times[body];
+        if (time >= 1.0f) {
+            continue;
+        }
+
+        Position& position = *m_positions[body];
+        position.x += m_motions[body].x * time;
+        position.y += m_motions[body].y * time;
+
+        m_impacts.push_back(Impact{ m_colliders[body]->entity_id, body, time });
+    }
+}
+
+float CollisionSystem::time_of_impact(uint32_t mover, uint32_t target, Vector2 motion) const {
+    const Collider& collider = *m_colliders[mover];
+    const Collider& other = *m_colliders[target];
+
+    const Vector2 center = collider.get_circle_center(*m_positions[mover]);
+    const float radius = std::fmax(collider.get_radius() - LINEAR_SLOP, 0.0f);
+
+    if (other.m_collider_type == (int)ColliderType::Circle) {
+        return sweep_circle_circle(center, radius, motion, other.get_circle_center(*m_positions[target]), other.get_radius());
+    }
+
+    return sweep_circle_aabb(center, radius, motion, other.get_bounds(*m_positions[target]));
+}
+
+void CollisionSystem::finish_impacts() {
+    for (Impact& impact : m_impacts) {
+        const Collider& collider = *m_colliders[impact.body];
+        if (collider.is_dead || !Query::has<Position, Velocity>(impact.id)) {
+            continue;
+        }
+
+        // the callbacks may have turned the body towards something else, so the
+        // rest of its motion is swept again after every impact
+        int impacts = 1;
+        while (impacts < MAX_IMPACTS && sweep_remaining(impact)) {
+            impacts++;
+        }
+
+        // the engine still moves the body along its whole velocity after this, so
+        // take back the part of the step already spent: it ends up where spending
+        // the rest of the step at the velocity the callbacks left it with would
+        auto [position, velocity] = Query::get<Position, Velocity>(impact.id);
+        position.x -= velocity.x * Query::delta_time() * impact.time;
+        position.y -= velocity.y * Query::delta_time() * impact.time;
+    }
+}
+
+bool CollisionSystem::sweep_remaining(Impact& impact) {
+    Collider& collider = *m_colliders[impact.body];
+    if (!collider.is_enable()) {
+        return false;
+    }
+
+    const auto& velocity = Query::read<Velocity>(impact.id);
+    const Vector2 motion = Vector2Scale(Vector2{ velocity.x, velocity.y }, Query::delta_time() * (1.0f - impact.time));
+    if (Vector2LengthSqr(motion) <= collider.get_radius() * collider.get_radius()) {
+        return false;
+    }
+
+    const Aabb bounds = collider.get_bounds(*m_positions[impact.body]);
+    const Aabb moved = { Vector2Add(bounds.min, motion), Vector2Add(bounds.max, motion) };
+
+    m_candidates.clear();
+    m_broad_phase.query(combine(bounds, moved), m_candidates);
+
+    float first = 1.0f;
+    uint32_t hit = impact.body;
+    for (uint32_t body : m_candidates) {
+        Collider& other = *m_colliders[body];
+        if (body == impact.body || other.is_dead || !other.is_enable()) {
+            continue;
+        }
+
+        const float time = time_of_impact(impact.body, body, motion);
+        if (time >= 0.0f && time < first) {
+            first = time;
+            hit = body;
+        }
+    }
+
+    if (hit == impact.body) {
+        return false;
+    }
+
+    Position& position = *m_positions[impact.body];
+    position.x += motion.x * first;
+    position.y += motion.y * first;
+    impact.time += (1.0f - impact.time) * first;
+
+    const Collider& other = *m_colliders[hit];
+    if (m_contacts.add_entered(collider.entity_id, other.entity_id, impact.body, hit)) {
+        notify(Contact{ collider.entity_id, other.entity_id, impact.body, hit }, &Collider::m_on_collision_enter);
+    }
+
+    return true;
+}
+
+void CollisionSystem::find_contacts() {
+    m_contacts.begin_step();
+
+    for (const ProxyPair& pair : m_pairs) {
+        const Collider& a = *m_colliders[pair.a];
+        const Collider& b = *m_colliders[pair.b];
+
+        if (a.intersects(b, *m_positions[pair.a], *m_positions[pair.b])) {
+            m_contacts.add(a.entity_id, b.entity_id, pair.a, pair.b);
+        }
+    }
+
+    m_contacts.update();
+}
+
+void CollisionSystem::dispatch_contacts() {
+    for (const Contact& contact : m_contacts.get_entered()) {
+        notify(contact, &Collider::m_on_collision_enter);
+    }
+
+    for (const Contact& contact : m_contacts.get_stayed()) {
+        notify(contact, &Collider::m_on_collision_stay);
+    }
+
+    for (const Contact& contact : m_contacts.get_exited()) {
+        notify_exit(contact.a, contact.b);
+        notify_exit(contact.b, contact.a);
+    }
+}
+
+void CollisionSystem::notify(const Contact& contact, Collider::collision_callback Collider::* callback) {
+    Collider& a = *m_colliders[contact.body_a];
+    Collider& b = *m_colliders[contact.body_b];
+
+    // an earlier callback of this step may have removed or disabled either side
+    if (a.is_dead || b.is_dead || !a.is_enable() || !b.is_enable()) {
+        return;
+    }
+
+    if (a.*callback) {
+        (a.*callback)(b);
+    }
+
+    if (b.*callback) {
+        (b.*callback)(a);
+    }
+}
+
+void CollisionSystem::notify_exit(uint64_t id, uint64_t other) {
+    if (!Query::has<Collider>(id)) {
+        return;
+    }
+
+    const Collider& collider = Query::read<Collider>(id);
+    if (!collider.is_dead && collider.m_on_collision_exit) {
+        collider.m_on_collision_exit(other);
+    }
+}
@@ -32,7 +32,7 @@ void Cube::handle_input() {
     // Using Query::read for Speed as it's read-only
     const auto& speed = Query::read<Speed>(this);
     
-    float delta_time = get_frame_time();
+    float delta_time = Query::delta_time();
     float movement_speed = speed.value;
     
     // Handle keyboard input for movement
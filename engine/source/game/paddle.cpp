@@ -6,7 +6,7 @@
 void Paddle::on_init() {}
 
 void Paddle::on_update() {
-    auto& position = Query::get<Position>(this);
+    const auto position = Query::interpolated<Position>(this);
     
     draw_rectangle(
         position.x - width / 2,
@@ -23,7 +23,7 @@ void Paddle::on_play_update() {
 void Paddle::handle_input() {
     auto& position = Query::get<Position>(this);
     
-    float delta_time = GetFrameTime();
+    float delta_time = Query::delta_time();
     
     if (is_key_down(KEY_LEFT) || is_key_down(KEY_A)) {
         position.x -= speed * delta_time;
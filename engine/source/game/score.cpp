@@ -4,13 +4,19 @@
 #include "core/query.h"
 
 void Score::on_play_start() {
+    auto self = Query::handle(*this);
+
     auto& game = Query::find_first<Game>();
-    game.register_on_brick_destoryed([this](const auto& brick){
-        on_break_destroyed(brick);
+    game.register_on_brick_destoryed([self](const auto& brick){
+        if (Score* score = self.resolve()) {
+            score->on_break_destroyed(brick);
+        }
     });
 
-    game.register_on_game_start([this](){
-        reset();
+    game.register_on_game_start([self](){
+        if (Score* score = self.resolve()) {
+            score->reset();
+        }
     });
 }
 
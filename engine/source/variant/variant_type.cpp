@@ -0,0 +1,89 @@
+#include "variant/variant_type.h"
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+    struct VariantTypeTable {
+        std::unordered_map<rttr::type, variant_type_index> indices;
+        std::vector<rttr::type> types;
+        std::vector<variant_type_index> order;
+        std::unordered_map<variant_hook_mask, std::vector<variant_type_index>> hooked;
+
+        VariantTypeTable() {
+            types.reserve(VARIANT_TYPE_COUNT);
+
+            for (variant_type_index i = 0; i < VARIANT_TYPE_COUNT; i++) {
+                rttr::type type = rttr::type::get_by_name(VARIANT_TYPE_NAMES[i]);
+                types.push_back(type);
+                if (type.is_valid()) {
+                    indices.emplace(type, i);
+                }
+
+                order.push_back(i);
+            }
+
+            build_hooked();
+        }
+
+        void build_hooked() {
+            hooked.clear();
+
+            for (variant_type_index i : order) {
+                for (variant_hook_mask hook = 1; hook != 0 && hook <= VARIANT_HOOKS[i]; hook <<= 1) {
+                    if (VARIANT_HOOKS[i] & hook) {
+                        hooked[hook].push_back(i);
+                    }
+                }
+            }
+        }
+    };
+
+    // Built on first use, RTTR registration has run by then.
+    VariantTypeTable& get_table() {
+        static VariantTypeTable table;
+        return table;
+    }
+}
+
+variant_type_index get_variant_type_index(const rttr::type& type) {
+    const auto& indices = get_table().indices;
+    auto it = indices.find(type);
+    return it != indices.end() ? it->second : INVALID_VARIANT_TYPE;
+}
+
+rttr::type get_variant_rttr_type(variant_type_index index) {
+    return get_table().types.at(index);
+}
+
+const std::vector<variant_type_index>& get_hooked_variant_types(VariantHook hook) {
+    static const std::vector<variant_type_index> none;
+
+    const auto& hooked = get_table().hooked;
+    auto it = hooked.find(hook);
+    return it != hooked.end() ? it->second : none;
+}
+
+void set_variant_dispatch_order(const std::vector<variant_type_index>& first) {
+    VariantTypeTable& table = get_table();
+
+    table.order.clear();
+    for (variant_type_index index : first) {
+        if (index < VARIANT_TYPE_COUNT && std::find(table.order.begin(), table.order.end(), index) == table.order.end()) {
+            table.order.push_back(index);
+        }
+    }
+
+    for (variant_type_index index = 0; index < VARIANT_TYPE_COUNT; index++) {
+        if (std::find(table.order.begin(), table.order.end(), index) == table.order.end()) {
+            table.order.push_back(index);
+        }
+    }
+
+    table.build_hooked();
+}
+
+const std::vector<variant_type_index>& get_variant_dispatch_order() {
+    return get_table().order;
+}